@@ -16,7 +16,10 @@ public class ClimbingSystem : ModuleRules
 			"Engine",
 			"InputCore",
 			"EnhancedInput",
-			"MotionWarping"
+			"AIModule",
+			"MotionWarping",
+			"MassEntity",
+			"MassCommon"
 		});
 	}
 }
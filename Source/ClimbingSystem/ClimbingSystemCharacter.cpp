@@ -3,14 +3,13 @@
 #include "ClimbingSystemCharacter.h"
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
-#include "Components/CapsuleComponent.h"
 #include "ClimbingSystem/Public/SRS_MovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/Controller.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "InputAction.h"
 #include "InputActionValue.h"
-#include "MotionWarpingComponent.h"
 #include "Debugger/DebugHelper.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
@@ -19,31 +18,8 @@ DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 // AClimbingSystemCharacter
 
 AClimbingSystemCharacter::AClimbingSystemCharacter(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer.SetDefaultSubobjectClass<USRS_MovementComponent>(ACharacter::CharacterMovementComponentName))
+	: Super(ObjectInitializer)
 {
-	// Set size for collision capsule
-	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
-		
-	// Don't rotate when the controller rotates. Let that just affect the camera.
-	bUseControllerRotationPitch = false;
-	bUseControllerRotationYaw = false;
-	bUseControllerRotationRoll = false;
-
-	CustomMovementComponent = Cast<USRS_MovementComponent>(GetCharacterMovement());
-
-	// Configure character movement
-	GetCharacterMovement()->bOrientRotationToMovement = true; // Character moves in the direction of input...	
-	GetCharacterMovement()->RotationRate = FRotator(0.0f, 500.0f, 0.0f); // ...at this rotation rate
-
-	// Note: For faster iteration times these variables, and many more, can be tweaked in the Character Blueprint
-	// instead of recompiling to adjust them
-	GetCharacterMovement()->JumpZVelocity = 700.f;
-	GetCharacterMovement()->AirControl = 0.35f;
-	GetCharacterMovement()->MaxWalkSpeed = 500.f;
-	GetCharacterMovement()->MinAnalogWalkSpeed = 20.f;
-	GetCharacterMovement()->BrakingDecelerationWalking = 2000.f;
-	GetCharacterMovement()->BrakingDecelerationFalling = 1500.0f;
-
 	// Create a camera boom (pulls in towards the player if there is a collision)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -54,18 +30,6 @@ AClimbingSystemCharacter::AClimbingSystemCharacter(const FObjectInitializer& Obj
 	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
-
-	MotionWarpingComponent = CreateDefaultSubobject<UMotionWarpingComponent>(TEXT("MotionWarpingComponent"));
-}
-
-void AClimbingSystemCharacter::OnEnterClimbState()
-{
-	AddInputMappingContext(ClimbMappingContext, 1);
-}
-
-void AClimbingSystemCharacter::OnExitClimbState()
-{
-	RemoveInputMappingContext(ClimbMappingContext);
 }
 
 void AClimbingSystemCharacter::AddInputMappingContext(UInputMappingContext* InContext, int32 InPriority)
@@ -79,30 +43,112 @@ void AClimbingSystemCharacter::AddInputMappingContext(UInputMappingContext* InCo
 	}
 }
 
-void AClimbingSystemCharacter::RemoveInputMappingContext(UInputMappingContext* InContext)
+void AClimbingSystemCharacter::BeginPlay()
 {
-	if (APlayerController* PlayerController = Cast<APlayerController>(GetController()))
+	Super::BeginPlay();
+	DefaultArmLength = CameraBoom->TargetArmLength;
+	DefaultTargetOffset = CameraBoom->TargetOffset;
+	if (GetCustomMovementComponent())
 	{
-		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
-		{
-			Subsystem->RemoveMappingContext(InContext);
-		}
+		GetCustomMovementComponent()->OnEnterClimbState.BindUObject(this, &ThisClass::OnEnterClimbState);
+		GetCustomMovementComponent()->OnExitClimbState.BindUObject(this, &ThisClass::OnExitClimbState);
 	}
 }
 
-void AClimbingSystemCharacter::BeginPlay()
+void AClimbingSystemCharacter::Tick(float DeltaSeconds)
 {
-	Super::BeginPlay();
-	if (CustomMovementComponent)
+	Super::Tick(DeltaSeconds);
+	if (IsLocallyControlled())
+	{
+		UpdateClimbCamera(DeltaSeconds);
+	}
+}
+
+void AClimbingSystemCharacter::OnEnterClimbState()
+{
+	bClimbCameraActive = true;
+	ClimbCameraWallNormal = GetCustomMovementComponent()->GetClimbableSurfaceNormal();
+	// Keep the arm's own test until the first probe says the wall is clear
+	ClimbCameraProbeTimer = 0.f;
+}
+
+void AClimbingSystemCharacter::OnExitClimbState()
+{
+	bClimbCameraActive = false;
+	CameraBoom->bDoCollisionTest = true;
+}
+
+void AClimbingSystemCharacter::UpdateClimbCamera(float DeltaSeconds)
+{
+	const float TargetAlpha = bClimbCameraActive ? 1.f : 0.f;
+	const bool bBlending = ClimbCameraAlpha != TargetAlpha;
+	if (bBlending)
+	{
+		ClimbCameraAlpha = FMath::FInterpTo(ClimbCameraAlpha, TargetAlpha, DeltaSeconds, ClimbCameraBlendSpeed);
+		if (FMath::IsNearlyEqual(ClimbCameraAlpha, TargetAlpha, 0.01f))
+		{
+			ClimbCameraAlpha = TargetAlpha;
+		}
+		CameraBoom->TargetArmLength = FMath::Lerp(DefaultArmLength, ClimbArmLength, ClimbCameraAlpha);
+	}
+	if (bClimbCameraActive)
+	{
+		// Ease towards the current wall so the pivot swings round corners instead of snapping
+		ClimbCameraWallNormal = FMath::VInterpTo(ClimbCameraWallNormal, GetCustomMovementComponent()->GetClimbableSurfaceNormal(), DeltaSeconds, ClimbCameraBlendSpeed);
+	}
+	if (bBlending || ClimbCameraAlpha > 0.f)
 	{
-		CustomMovementComponent->OnEnterClimbState.BindUObject(this, &ThisClass::OnEnterClimbState);
-		CustomMovementComponent->OnExitClimbState.BindUObject(this, &ThisClass::OnExitClimbState);
+		const FVector ClimbOffset = ClimbTargetOffset + ClimbCameraWallNormal * ClimbCameraWallOffset;
+		CameraBoom->TargetOffset = FMath::Lerp(DefaultTargetOffset, ClimbOffset, ClimbCameraAlpha);
 	}
+	if (!bClimbCameraActive) { return; }
+
+	const FRotator ControlRotation = GetControlRotation();
+	ClimbCameraProbeTimer -= DeltaSeconds;
+	const bool bViewTurned = !ControlRotation.Equals(LastClimbCameraProbeRotation, ClimbCameraReprobeAngle);
+	if (ClimbCameraProbeTimer > 0.f && !bViewTurned) { return; }
+	ClimbCameraProbeTimer = ClimbCameraProbeInterval;
+	LastClimbCameraProbeRotation = ControlRotation;
+	CameraBoom->bDoCollisionTest = !IsClimbCameraClear();
+}
+
+bool AClimbingSystemCharacter::IsClimbCameraClear() const
+{
+	const USRS_MovementComponent* Movement = GetCustomMovementComponent();
+	if (!Movement) { return false; }
+	const FVector Pivot = CameraBoom->GetComponentLocation() + CameraBoom->TargetOffset;
+	const FVector DesiredLocation = Pivot - GetControlRotation().Vector() * CameraBoom->TargetArmLength;
+
+	// The movement component already knows the wall, a camera behind its plane needs the arm's own test
+	const float WallDistance = FVector::DotProduct(DesiredLocation - Movement->GetClimbableSurfaceLocation(), Movement->GetClimbableSurfaceNormal());
+	if (WallDistance < ClimbCameraWallClearance) { return false; }
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbCameraProbe), false, this);
+	return !GetWorld()->SweepTestByChannel
+	(
+		Pivot,
+		DesiredLocation,
+		FQuat::Identity,
+		CameraBoom->ProbeChannel,
+		FCollisionShape::MakeSphere(CameraBoom->ProbeSize),
+		QueryParams
+	);
 }
 
 void AClimbingSystemCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
+	// Both contexts stay registered for the pawn's lifetime at equal priority, the handlers gate on climb state instead of the mappings
+	// being rebuilt on every transition. The move actions share keys, so neither may consume them or the other never fires.
+	for (UInputAction* SharedAction : { MoveAction, ClimbMoveAction })
+	{
+		if (SharedAction && SharedAction->bConsumeInput)
+		{
+			UE_LOG(LogTemplateCharacter, Warning, TEXT("'%s' shares its keys with the other move action, clearing Consume Input"), *SharedAction->GetName());
+			SharedAction->bConsumeInput = false;
+		}
+	}
 	AddInputMappingContext(DefaultMappingContext, 0);
+	AddInputMappingContext(ClimbMappingContext, 0);
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
 	{
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
@@ -117,6 +163,7 @@ void AClimbingSystemCharacter::SetupPlayerInputComponent(UInputComponent* Player
 
 void AClimbingSystemCharacter::HandleGroundInput(const FInputActionValue& Value)
 {
+	if (GetCustomMovementComponent() && GetCustomMovementComponent()->IsClimbing()) { return; }
  	const FVector2D MovementVector = Value.Get<FVector2D>();
 
 	if (Controller != nullptr)
@@ -134,17 +181,18 @@ void AClimbingSystemCharacter::HandleGroundInput(const FInputActionValue& Value)
 
 void AClimbingSystemCharacter::HandleClimbInput(const FInputActionValue& Value)
 {
+	if (!GetCustomMovementComponent() || !GetCustomMovementComponent()->IsClimbing()) { return; }
 	const FVector2D MovementVector = Value.Get<FVector2D>();
 	if (Controller != nullptr)
 	{
 		const FVector ForwardDirection = FVector::CrossProduct
 		(
-			-CustomMovementComponent->GetClimbableSurfaceNormal(),
+			-GetCustomMovementComponent()->GetClimbableSurfaceNormal(),
 			GetActorRightVector()
 		);
 		const FVector RightDirection = FVector::CrossProduct
 		(
-			-CustomMovementComponent->GetClimbableSurfaceNormal(),
+			-GetCustomMovementComponent()->GetClimbableSurfaceNormal(),
 			-GetActorUpVector()
 		);
 		AddMovementInput(ForwardDirection, MovementVector.Y);
@@ -167,19 +215,19 @@ void AClimbingSystemCharacter::Look(const FInputActionValue& Value)
 
 void AClimbingSystemCharacter::ClimbActionStarted(const FInputActionValue& Value)
 {
-	if (!CustomMovementComponent) { return; }
-	if (!CustomMovementComponent->IsClimbing())
+	if (!GetCustomMovementComponent()) { return; }
+	if (!GetCustomMovementComponent()->IsClimbing())
 	{
-		CustomMovementComponent->ToggleClimbing(true);
+		GetCustomMovementComponent()->QueueClimbCommand(ESRS_ClimbCommandType::StartClimb);
 	}
 	else
 	{
-		CustomMovementComponent->ToggleClimbing(false);
+		GetCustomMovementComponent()->QueueClimbCommand(ESRS_ClimbCommandType::StopClimb);
 	}
 }
 
 void AClimbingSystemCharacter::ClimbHopActionStarted(const FInputActionValue& Value)
 {
-	if (!CustomMovementComponent) { return; }
-	CustomMovementComponent->RequestHop();
+	if (!GetCustomMovementComponent() || !GetCustomMovementComponent()->IsClimbing()) { return; }
+	GetCustomMovementComponent()->QueueClimbCommand(ESRS_ClimbCommandType::Hop);
 }
@@ -3,7 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameFramework/Character.h"
+#include "ClimbingSystem/Public/Characters/SRS_ClimberCharacter.h"
 #include "Logging/LogMacros.h"
 #include "ClimbingSystemCharacter.generated.h"
 
@@ -12,13 +12,11 @@ class UCameraComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
-class USRS_MovementComponent;
-class UMotionWarpingComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
 UCLASS(config=Game)
-class AClimbingSystemCharacter : public ACharacter
+class AClimbingSystemCharacter : public ASRS_ClimberCharacter
 {
 	GENERATED_BODY()
 
@@ -31,18 +29,47 @@ private:
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FollowCamera;
-	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	USRS_MovementComponent* CustomMovementComponent;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
-	UMotionWarpingComponent* MotionWarpingComponent;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	float ClimbArmLength { 300.f };
+
+	// World space offset of the arm pivot while climbing, lifts the view off the climber's shoulders
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	FVector ClimbTargetOffset { 0.f, 0.f, 60.f };
+
+	// Pushes the arm pivot out along the climbed wall's normal, so the view backs off the wall and follows it round corners
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	float ClimbCameraWallOffset { 80.f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbCameraBlendSpeed { 4.f };
+
+	// How often the climb camera checks that the arm is clear, the spring arm skips its own sweep while it is
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbCameraProbeInterval { 0.25f };
+
+	// Turning the view further than this re-probes straight away
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbCameraReprobeAngle { 10.f };
+
+	// Closest the camera may get to the climbed wall's plane before the arm has to test collision every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	float ClimbCameraWallClearance { 40.f };
 
 	void OnEnterClimbState();
 	void OnExitClimbState();
+	void UpdateClimbCamera(float DeltaSeconds);
+	bool IsClimbCameraClear() const;
+
+	bool bClimbCameraActive { false };
+	float ClimbCameraAlpha { 0.f };
+	float ClimbCameraProbeTimer { 0.f };
+	FRotator LastClimbCameraProbeRotation { FRotator::ZeroRotator };
+	float DefaultArmLength { 0.f };
+	FVector DefaultTargetOffset { FVector::ZeroVector };
+	FVector ClimbCameraWallNormal { FVector::ZeroVector };
 
 	void AddInputMappingContext(UInputMappingContext* InContext, int32 InPriority);
-	void RemoveInputMappingContext(UInputMappingContext* InContext);
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	UInputMappingContext* DefaultMappingContext;
@@ -81,14 +108,12 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	virtual void Tick(float DeltaSeconds) override;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE  USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE  UCameraComponent* GetFollowCamera() const { return FollowCamera; }
-	/** Returns CustomMovementComponent subobject **/
-	FORCEINLINE  USRS_MovementComponent* GetCustomMovementComponent() const { return CustomMovementComponent; }
-	/** Returns MotionWarpingComponent subobject **/
-	FORCEINLINE  UMotionWarpingComponent* GetMotionWarpingComponent() const { return MotionWarpingComponent; }
 };
 
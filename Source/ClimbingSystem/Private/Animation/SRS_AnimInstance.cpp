@@ -3,7 +3,7 @@
 
 #include "Animation/SRS_AnimInstance.h"
 
-#include "ClimbingSystem/ClimbingSystemCharacter.h"
+#include "ClimbingSystem/Public/Characters/SRS_ClimberCharacter.h"
 #include "ClimbingSystem/Public/SRS_MovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 
@@ -11,7 +11,7 @@ void USRS_AnimInstance::NativeInitializeAnimation()
 {
 	Super::NativeInitializeAnimation();
 
-	ClimbingSystemCharacter = Cast<AClimbingSystemCharacter>(TryGetPawnOwner());
+	ClimbingSystemCharacter = Cast<ASRS_ClimberCharacter>(TryGetPawnOwner());
 	if (ClimbingSystemCharacter)
 	{
 		CustomMovementComponent = ClimbingSystemCharacter->GetCustomMovementComponent();
@@ -28,7 +28,9 @@ void USRS_AnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 	GetShouldMove();
 	GetIsFalling();
 	GetIsClimbing();
+	GetIsLedgeHanging();
 	GetClimbVelocity();
+	GetClimbLocomotion(DeltaSeconds);
 }
 
 void USRS_AnimInstance::GetGroundSpeed()
@@ -58,7 +60,55 @@ void USRS_AnimInstance::GetIsClimbing()
 	bIsClimbing = CustomMovementComponent->IsClimbing();
 }
 
+void USRS_AnimInstance::GetIsLedgeHanging()
+{
+	bIsLedgeHanging = CustomMovementComponent->IsLedgeHanging();
+}
+
 void USRS_AnimInstance::GetClimbVelocity()
 {
 	ClimbVelocity = CustomMovementComponent->GetUnrotatedClimbVelocity();
 }
+
+void USRS_AnimInstance::GetClimbLocomotion(float DeltaSeconds)
+{
+	if (!bIsClimbing)
+	{
+		ClimbPoseWeights = FSRS_ClimbPoseWeights();
+		ClimbStridePhase = 0.f;
+		ClimbLimbAlternation = 0.f;
+		ClimbDistanceTravelled = 0.f;
+		ClimbStopDistance = 0.f;
+		return;
+	}
+
+	// The phase follows the distance actually covered so hands and feet plant without sliding
+	const float DistanceTravelled = CustomMovementComponent->GetClimbDistanceTravelled();
+	const float DistanceDelta = FMath::Max(DistanceTravelled - ClimbDistanceTravelled, 0.f);
+	ClimbDistanceTravelled = DistanceTravelled;
+	ClimbStopDistance = CustomMovementComponent->PredictClimbStopDistance();
+	ClimbStridePhase = FMath::Fmod(ClimbStridePhase + DistanceDelta / ClimbStrideLength, 1.f);
+	ClimbLimbAlternation = 0.5f - 0.5f * FMath::Cos(ClimbStridePhase * UE_TWO_PI);
+
+	// Climb velocity is in the climber's frame, Y runs along the wall to the right and Z up it
+	const FVector2D PlanarVelocity(ClimbVelocity.Y, ClimbVelocity.Z);
+	const float MaxSpeed = ClimbingSystemCharacter->GetCharacterMovement()->GetMaxSpeed();
+	const float MoveAlpha = MaxSpeed > 0.f ? FMath::Clamp(PlanarVelocity.Size() / MaxSpeed, 0.f, 1.f) : 0.f;
+	FSRS_ClimbPoseWeights TargetWeights;
+	const FVector2D Direction = PlanarVelocity.GetSafeNormal();
+	const float DirectionSum = FMath::Abs(Direction.X) + FMath::Abs(Direction.Y);
+	if (DirectionSum > UE_KINDA_SMALL_NUMBER)
+	{
+		const float Scale = MoveAlpha / DirectionSum;
+		TargetWeights.Idle = 1.f - MoveAlpha;
+		TargetWeights.Up = FMath::Max(Direction.Y, 0.f) * Scale;
+		TargetWeights.Down = FMath::Max(-Direction.Y, 0.f) * Scale;
+		TargetWeights.Right = FMath::Max(Direction.X, 0.f) * Scale;
+		TargetWeights.Left = FMath::Max(-Direction.X, 0.f) * Scale;
+	}
+	ClimbPoseWeights.Idle = FMath::FInterpTo(ClimbPoseWeights.Idle, TargetWeights.Idle, DeltaSeconds, ClimbPoseBlendSpeed);
+	ClimbPoseWeights.Up = FMath::FInterpTo(ClimbPoseWeights.Up, TargetWeights.Up, DeltaSeconds, ClimbPoseBlendSpeed);
+	ClimbPoseWeights.Down = FMath::FInterpTo(ClimbPoseWeights.Down, TargetWeights.Down, DeltaSeconds, ClimbPoseBlendSpeed);
+	ClimbPoseWeights.Right = FMath::FInterpTo(ClimbPoseWeights.Right, TargetWeights.Right, DeltaSeconds, ClimbPoseBlendSpeed);
+	ClimbPoseWeights.Left = FMath::FInterpTo(ClimbPoseWeights.Left, TargetWeights.Left, DeltaSeconds, ClimbPoseBlendSpeed);
+}
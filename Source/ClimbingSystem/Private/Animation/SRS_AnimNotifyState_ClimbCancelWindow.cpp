@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/SRS_AnimNotifyState_ClimbCancelWindow.h"
+
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+
+void USRS_AnimNotifyState_ClimbCancelWindow::SetWindowOpen(USRS_MovementComponent* Movement, bool bOpen) const
+{
+	Movement->SetClimbCancelWindowOpen(bOpen);
+}
@@ -0,0 +1,11 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/SRS_AnimNotifyState_ClimbInputWindow.h"
+
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+
+void USRS_AnimNotifyState_ClimbInputWindow::SetWindowOpen(USRS_MovementComponent* Movement, bool bOpen) const
+{
+	Movement->SetClimbInputWindowOpen(bOpen);
+}
@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/SRS_AnimNotifyState_ClimbWindow.h"
+
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+
+USRS_MovementComponent* USRS_AnimNotifyState_ClimbWindow::GetClimbMovement(const USkeletalMeshComponent* MeshComp)
+{
+	const ACharacter* Character = MeshComp ? Cast<ACharacter>(MeshComp->GetOwner()) : nullptr;
+	return Character ? Cast<USRS_MovementComponent>(Character->GetCharacterMovement()) : nullptr;
+}
+
+void USRS_AnimNotifyState_ClimbWindow::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation,
+	float TotalDuration, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+	if (USRS_MovementComponent* Movement = GetClimbMovement(MeshComp))
+	{
+		SetWindowOpen(Movement, true);
+	}
+}
+
+void USRS_AnimNotifyState_ClimbWindow::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation,
+	const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+	if (USRS_MovementComponent* Movement = GetClimbMovement(MeshComp))
+	{
+		SetWindowOpen(Movement, false);
+	}
+}
@@ -0,0 +1,105 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/SRS_BakedRootMotion.h"
+
+#include "Animation/AnimMontage.h"
+#include "UObject/ObjectSaveContext.h"
+
+#if WITH_EDITOR
+#include "AnimNotifyState_MotionWarping.h"
+#include "RootMotionModifier.h"
+#endif
+
+FTransform FSRS_BakedRootMotionTrack::Sample(float Time) const
+{
+	if (Translations.IsEmpty()) { return FTransform::Identity; }
+
+	const float SampleTime = FMath::Clamp(Time, 0.f, Duration) * SampleRate;
+	const int32 Index = FMath::Min(FMath::FloorToInt32(SampleTime), Translations.Num() - 1);
+	const int32 NextIndex = FMath::Min(Index + 1, Translations.Num() - 1);
+	const float Alpha = SampleTime - Index;
+
+	const FVector Translation = FVector(FMath::Lerp(Translations[Index], Translations[NextIndex], Alpha));
+	const FQuat Rotation = FQuat(FQuat4f::Slerp(Rotations[Index], Rotations[NextIndex], Alpha));
+	return FTransform(Rotation, Translation);
+}
+
+FTransform FSRS_BakedRootMotionTrack::ExtractDelta(float StartTime, float EndTime) const
+{
+	return Sample(EndTime).GetRelativeTransform(Sample(StartTime));
+}
+
+const FSRS_BakedWarpWindow* FSRS_BakedRootMotionTrack::FindWarpWindow(float Time) const
+{
+	return WarpWindows.FindByPredicate([Time](const FSRS_BakedWarpWindow& Window)
+	{
+		return Time >= Window.StartTime && Time < Window.EndTime;
+	});
+}
+
+const FSRS_BakedRootMotionTrack* USRS_BakedRootMotionSet::FindTrack(const FSoftObjectPath& MontagePath) const
+{
+	if (!MontagePath.IsValid()) { return nullptr; }
+	return Tracks.FindByPredicate([&MontagePath](const FSRS_BakedRootMotionTrack& Track)
+	{
+		return Track.Montage.ToSoftObjectPath() == MontagePath && !Track.Translations.IsEmpty();
+	});
+}
+
+bool USRS_BakedRootMotionSet::HasTracksFor(TConstArrayView<FSoftObjectPath> MontagePaths) const
+{
+	for (const FSoftObjectPath& MontagePath : MontagePaths)
+	{
+		if (!FindTrack(MontagePath)) { return false; }
+	}
+	return true;
+}
+
+#if WITH_EDITOR
+void USRS_BakedRootMotionSet::BakeTracks()
+{
+	Modify();
+	for (FSRS_BakedRootMotionTrack& Track : Tracks)
+	{
+		Track.Translations.Reset();
+		Track.Rotations.Reset();
+		Track.WarpWindows.Reset();
+
+		const UAnimMontage* Montage = Track.Montage.LoadSynchronous();
+		if (!Montage) { continue; }
+
+		Track.SampleRate = BakeSampleRate;
+		Track.Duration = Montage->GetPlayLength();
+		const int32 NumSamples = FMath::CeilToInt32(Track.Duration * Track.SampleRate) + 1;
+		const FAnimExtractContext ExtractContext;
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			const float Time = FMath::Min(Index / Track.SampleRate, Track.Duration);
+			const FTransform RootMotion = Montage->ExtractRootMotionFromTrackRange(0.f, Time, ExtractContext);
+			Track.Translations.Add(FVector3f(RootMotion.GetTranslation()));
+			Track.Rotations.Add(FQuat4f(RootMotion.GetRotation()));
+		}
+
+		for (const FAnimNotifyEvent& Notify : Montage->Notifies)
+		{
+			const UAnimNotifyState_MotionWarping* WarpNotify = Cast<UAnimNotifyState_MotionWarping>(Notify.NotifyStateClass);
+			const URootMotionModifier_Warp* Warp = WarpNotify ? Cast<URootMotionModifier_Warp>(WarpNotify->RootMotionModifier) : nullptr;
+			if (!Warp) { continue; }
+			FSRS_BakedWarpWindow& Window = Track.WarpWindows.AddDefaulted_GetRef();
+			Window.WarpTargetName = Warp->WarpTargetName;
+			Window.StartTime = Notify.GetTriggerTime();
+			Window.EndTime = Notify.GetEndTriggerTime();
+		}
+	}
+}
+
+void USRS_BakedRootMotionSet::PreSave(FObjectPreSaveContext SaveContext)
+{
+	if (SaveContext.IsCooking())
+	{
+		BakeTracks();
+	}
+	Super::PreSave(SaveContext);
+}
+#endif
@@ -0,0 +1,69 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/SRS_ClimbMontageSet.h"
+
+#include "Animation/AnimMontage.h"
+
+const TSoftObjectPtr<UAnimMontage>& USRS_ClimbMontageSet::GetSoftMontage(ESRS_ClimbMontage Montage) const
+{
+	switch (Montage)
+	{
+	case ESRS_ClimbMontage::ClimbUpLedge:
+		return ClimbUpLedge;
+	case ESRS_ClimbMontage::ClimbDownLedge:
+		return ClimbDownLedge;
+	case ESRS_ClimbMontage::Vault:
+		return Vault;
+	case ESRS_ClimbMontage::HopUp:
+		return HopUp;
+	case ESRS_ClimbMontage::HopDown:
+		return HopDown;
+	default:
+		return IdleToClimb;
+	}
+}
+
+UAnimMontage* USRS_ClimbMontageSet::GetLoadedMontage(ESRS_ClimbMontage Montage) const
+{
+	return GetSoftMontage(Montage).Get();
+}
+
+bool USRS_ClimbMontageSet::FindMontage(const UAnimMontage* Montage, ESRS_ClimbMontage& OutMontage) const
+{
+	if (!Montage) { return false; }
+	for (uint8 Index = 0; Index < static_cast<uint8>(ESRS_ClimbMontage::Count); ++Index)
+	{
+		const ESRS_ClimbMontage Candidate = static_cast<ESRS_ClimbMontage>(Index);
+		if (GetLoadedMontage(Candidate) == Montage)
+		{
+			OutMontage = Candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+TArray<FSoftObjectPath> USRS_ClimbMontageSet::GetMontagePaths() const
+{
+	TArray<FSoftObjectPath> Paths;
+	for (uint8 Index = 0; Index < static_cast<uint8>(ESRS_ClimbMontage::Count); ++Index)
+	{
+		const FSoftObjectPath& Path = GetSoftMontage(static_cast<ESRS_ClimbMontage>(Index)).ToSoftObjectPath();
+		if (Path.IsValid())
+		{
+			Paths.Add(Path);
+		}
+	}
+	return Paths;
+}
+
+bool USRS_ClimbMontageSet::AreMontagesLoaded() const
+{
+	for (uint8 Index = 0; Index < static_cast<uint8>(ESRS_ClimbMontage::Count); ++Index)
+	{
+		const TSoftObjectPtr<UAnimMontage>& Montage = GetSoftMontage(static_cast<ESRS_ClimbMontage>(Index));
+		if (!Montage.IsNull() && !Montage.IsValid()) { return false; }
+	}
+	return true;
+}
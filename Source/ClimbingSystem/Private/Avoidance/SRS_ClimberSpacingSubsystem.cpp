@@ -0,0 +1,159 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Avoidance/SRS_ClimberSpacingSubsystem.h"
+
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+void USRS_ClimberSpacingSubsystem::Deinitialize()
+{
+	Climbers.Reset();
+	Anchors.Reset();
+	AnchorKeys.Reset();
+	CellRanges.Reset();
+	Super::Deinitialize();
+}
+
+void USRS_ClimberSpacingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	Rebuild();
+}
+
+TStatId USRS_ClimberSpacingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USRS_ClimberSpacingSubsystem, STATGROUP_Tickables);
+}
+
+bool USRS_ClimberSpacingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USRS_ClimberSpacingSubsystem::RegisterClimber(USRS_MovementComponent* Climber)
+{
+	if (!Climber) { return; }
+	Climbers.AddUnique(Climber);
+}
+
+void USRS_ClimberSpacingSubsystem::UnregisterClimber(USRS_MovementComponent* Climber)
+{
+	Climbers.RemoveSwap(Climber);
+}
+
+FVector USRS_ClimberSpacingSubsystem::ProjectAnchor(const FVector& Location, const FVector& SurfaceLocation, const FVector& SurfaceNormal)
+{
+	return FVector::PointPlaneProject(Location, SurfaceLocation, SurfaceNormal);
+}
+
+FIntVector USRS_ClimberSpacingSubsystem::GetCell(const FVector& Location) const
+{
+	const FVector Scaled = Location / SeparationRadius;
+	return FIntVector(FMath::FloorToInt32(Scaled.X), FMath::FloorToInt32(Scaled.Y), FMath::FloorToInt32(Scaled.Z));
+}
+
+uint64 USRS_ClimberSpacingSubsystem::GetCellKey(const FIntVector& Cell)
+{
+	// 21 bits per axis covers +-1M cells, far beyond any playable world at climber spacing
+	constexpr uint64 Mask = (1ull << 21) - 1;
+	return (static_cast<uint64>(Cell.X) & Mask) | ((static_cast<uint64>(Cell.Y) & Mask) << 21) | ((static_cast<uint64>(Cell.Z) & Mask) << 42);
+}
+
+void USRS_ClimberSpacingSubsystem::Rebuild()
+{
+	Anchors.Reset();
+	CellRanges.Reset();
+	Climbers.RemoveAllSwap([](const USRS_MovementComponent* Climber) { return !IsValid(Climber); });
+	if (Climbers.Num() < 2)
+	{
+		AnchorKeys.Reset();
+		return;
+	}
+
+	// Read component state on the game thread, then project and hash in parallel
+	TArray<FVector> Locations;
+	TArray<FVector> SurfaceLocations;
+	TArray<FVector> SurfaceNormals;
+	Locations.SetNumUninitialized(Climbers.Num());
+	SurfaceLocations.SetNumUninitialized(Climbers.Num());
+	SurfaceNormals.SetNumUninitialized(Climbers.Num());
+	for (int32 Index = 0; Index < Climbers.Num(); ++Index)
+	{
+		Locations[Index] = Climbers[Index]->UpdatedComponent->GetComponentLocation();
+		SurfaceLocations[Index] = Climbers[Index]->GetClimbableSurfaceLocation();
+		SurfaceNormals[Index] = Climbers[Index]->GetClimbableSurfaceNormal();
+	}
+
+	TArray<TPair<uint64, int32>> Keyed;
+	Keyed.SetNumUninitialized(Climbers.Num());
+	TArray<FVector> Projected;
+	Projected.SetNumUninitialized(Climbers.Num());
+	ParallelFor(Climbers.Num(), [&](int32 Index)
+	{
+		Projected[Index] = ProjectAnchor(Locations[Index], SurfaceLocations[Index], SurfaceNormals[Index]);
+		Keyed[Index] = TPair<uint64, int32>(GetCellKey(GetCell(Projected[Index])), Index);
+	});
+	Algo::SortBy(Keyed, [](const TPair<uint64, int32>& Entry) { return Entry.Key; });
+
+	Anchors.SetNumUninitialized(Keyed.Num());
+	AnchorKeys.SetNumUninitialized(Keyed.Num());
+	for (int32 Index = 0; Index < Keyed.Num(); ++Index)
+	{
+		const int32 ClimberIndex = Keyed[Index].Value;
+		Anchors[Index] = { Projected[ClimberIndex], SurfaceNormals[ClimberIndex], Climbers[ClimberIndex] };
+		AnchorKeys[Index] = Keyed[Index].Key;
+		if (Index == 0 || AnchorKeys[Index - 1] != AnchorKeys[Index])
+		{
+			CellRanges.Add(AnchorKeys[Index], { Index, 0 });
+		}
+		++CellRanges.FindChecked(AnchorKeys[Index]).Num;
+	}
+}
+
+FVector USRS_ClimberSpacingSubsystem::ComputeSeparation(const USRS_MovementComponent* Climber, const FVector& Anchor, const FVector& SurfaceNormal) const
+{
+	if (CellRanges.IsEmpty()) { return FVector::ZeroVector; }
+
+	const float RadiusSquared = FMath::Square(SeparationRadius);
+	// Anchors further off the climber's wall plane than a capsule radius belong to a parallel wall, not this one
+	const ACharacter* Character = Climber ? Climber->GetCharacterOwner() : nullptr;
+	const float MaxPlaneDistance = Character ? Character->GetCapsuleComponent()->GetScaledCapsuleRadius() : SeparationRadius;
+	const FIntVector Cell = GetCell(Anchor);
+	FVector Separation = FVector::ZeroVector;
+	for (int32 X = -1; X <= 1; ++X)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			for (int32 Z = -1; Z <= 1; ++Z)
+			{
+				const FCellRange* Range = CellRanges.Find(GetCellKey(Cell + FIntVector(X, Y, Z)));
+				if (!Range) { continue; }
+				for (int32 Index = Range->Start; Index < Range->Start + Range->Num; ++Index)
+				{
+					const FAnchor& Other = Anchors[Index];
+					if (Other.Climber == Climber) { continue; }
+					if (FVector::DotProduct(Other.SurfaceNormal, SurfaceNormal) < MinSharedWallDot) { continue; }
+					if (FMath::Abs(FVector::PointPlaneDist(Other.Location, Anchor, SurfaceNormal)) > MaxPlaneDistance) { continue; }
+					const FVector Offset = FVector::VectorPlaneProject(Anchor - Other.Location, SurfaceNormal);
+					const float DistanceSquared = Offset.SizeSquared();
+					if (DistanceSquared >= RadiusSquared) { continue; }
+					if (DistanceSquared < UE_KINDA_SMALL_NUMBER)
+					{
+						// Stacked exactly on top of each other, split them sideways by address so they pick opposite directions
+						const FVector Side = FVector::CrossProduct(SurfaceNormal, FVector::UpVector).GetSafeNormal();
+						Separation += Climber < Other.Climber ? Side : -Side;
+						continue;
+					}
+					const float Distance = FMath::Sqrt(DistanceSquared);
+					Separation += Offset / Distance * (1.f - Distance / SeparationRadius);
+				}
+			}
+		}
+	}
+	return Separation;
+}
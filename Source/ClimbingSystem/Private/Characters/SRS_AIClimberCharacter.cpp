@@ -0,0 +1,97 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/SRS_AIClimberCharacter.h"
+
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Controller.h"
+
+namespace
+{
+	// Pooled pawns keep their controller, so its brain has to sleep with them
+	void SetPooledControllerPaused(AController* Controller, bool bPaused)
+	{
+		if (!Controller) { return; }
+		Controller->SetActorTickEnabled(!bPaused);
+		AAIController* AIController = Cast<AAIController>(Controller);
+		UBrainComponent* Brain = AIController ? AIController->GetBrainComponent() : nullptr;
+		if (!Brain) { return; }
+		Brain->SetComponentTickEnabled(!bPaused);
+		if (bPaused)
+		{
+			Brain->PauseLogic(TEXT("Pooled"));
+		}
+		else if (Brain->IsPaused())
+		{
+			Brain->ResumeLogic(TEXT("Pooled"));
+		}
+	}
+}
+
+ASRS_AIClimberCharacter::ASRS_AIClimberCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+
+	// Off-screen AI only needs montages ticked for their root motion
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+}
+
+void ASRS_AIClimberCharacter::OnAcquiredFromPool(const FTransform& SpawnTransform, AController* InController)
+{
+	bIsPooled = false;
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	USRS_MovementComponent* Movement = GetCustomMovementComponent();
+	// Baked root motion servers keep the mesh switched off for good
+	GetMesh()->SetComponentTickEnabled(!Movement || !Movement->IsBakedRootMotionOnly());
+	if (Movement)
+	{
+		Movement->SetComponentTickEnabled(true);
+		Movement->SetDefaultMovementMode();
+	}
+	if (InController && InController != GetController())
+	{
+		// The handed-in controller carries the brain state, a leftover pooled controller does not
+		if (AController* PreviousController = GetController())
+		{
+			PreviousController->UnPossess();
+			PreviousController->Destroy();
+		}
+		InController->Possess(this);
+	}
+	else if (!GetController())
+	{
+		SpawnDefaultController();
+	}
+	SetPooledControllerPaused(GetController(), false);
+}
+
+void ASRS_AIClimberCharacter::OnReturnedToPool()
+{
+	bIsPooled = true;
+	if (USRS_MovementComponent* Movement = GetCustomMovementComponent())
+	{
+		Movement->ResetClimbState();
+		Movement->SetComponentTickEnabled(false);
+	}
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.f);
+	}
+	if (AController* PooledController = GetController())
+	{
+		PooledController->StopMovement();
+		SetPooledControllerPaused(PooledController, true);
+	}
+	GetMesh()->SetComponentTickEnabled(false);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
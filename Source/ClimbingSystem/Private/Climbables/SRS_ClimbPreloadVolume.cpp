@@ -0,0 +1,29 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Climbables/SRS_ClimbPreloadVolume.h"
+
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "GameFramework/Character.h"
+
+void ASRS_ClimbPreloadVolume::NotifyActorBeginOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorBeginOverlap(OtherActor);
+	const ACharacter* Character = Cast<ACharacter>(OtherActor);
+	if (!Character) { return; }
+	if (USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Character->GetCharacterMovement()))
+	{
+		Movement->EnterClimbPreloadRegion();
+	}
+}
+
+void ASRS_ClimbPreloadVolume::NotifyActorEndOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorEndOverlap(OtherActor);
+	const ACharacter* Character = Cast<ACharacter>(OtherActor);
+	if (!Character) { return; }
+	if (USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Character->GetCharacterMovement()))
+	{
+		Movement->ExitClimbPreloadRegion();
+	}
+}
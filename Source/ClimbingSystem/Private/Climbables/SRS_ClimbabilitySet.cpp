@@ -0,0 +1,33 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Climbables/SRS_ClimbabilitySet.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+uint8 USRS_ClimbabilitySet::ResolveClassId(const UPrimitiveComponent* Component) const
+{
+	if (!Component) { return 0; }
+	const int32 NumClasses = FMath::Min(Classes.Num(), static_cast<int32>(MAX_uint8));
+	for (int32 Index = 0; Index < NumClasses; ++Index)
+	{
+		const FName& Tag = Classes[Index].ComponentTag;
+		if (!Tag.IsNone() && Component->ComponentHasTag(Tag)) { return static_cast<uint8>(Index + 1); }
+	}
+
+	// The body's simple material, per-face materials of complex collision are not told apart
+	const FBodyInstance* BodyInstance = Component->GetBodyInstance();
+	const UPhysicalMaterial* PhysicalMaterial = BodyInstance ? BodyInstance->GetSimplePhysicalMaterial() : nullptr;
+	if (!PhysicalMaterial) { return 0; }
+	for (int32 Index = 0; Index < NumClasses; ++Index)
+	{
+		if (Classes[Index].PhysicalMaterial == PhysicalMaterial) { return static_cast<uint8>(Index + 1); }
+	}
+	return 0;
+}
+
+const FSRS_ClimbabilityClass& USRS_ClimbabilitySet::GetClass(uint8 ClassId) const
+{
+	return Classes.IsValidIndex(ClassId - 1) ? Classes[ClassId - 1] : DefaultClass;
+}
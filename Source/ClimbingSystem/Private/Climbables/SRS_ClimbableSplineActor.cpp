@@ -0,0 +1,88 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Climbables/SRS_ClimbableSplineActor.h"
+
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Components/BoxComponent.h"
+#include "Components/SplineComponent.h"
+#include "GameFramework/Character.h"
+
+ASRS_ClimbableSplineActor::ASRS_ClimbableSplineActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	ClimbSpline = CreateDefaultSubobject<USplineComponent>(TEXT("ClimbSpline"));
+	SetRootComponent(ClimbSpline);
+	// Straight ladder from the origin up, facing +X
+	ClimbSpline->ClearSplinePoints(false);
+	ClimbSpline->AddSplinePoint(FVector::ZeroVector, ESplineCoordinateSpace::Local, false);
+	ClimbSpline->AddSplinePoint(FVector(0.f, 0.f, 400.f), ESplineCoordinateSpace::Local, false);
+	ClimbSpline->SetUpVectorAtSplinePoint(0, FVector::ForwardVector, ESplineCoordinateSpace::Local, false);
+	ClimbSpline->SetUpVectorAtSplinePoint(1, FVector::ForwardVector, ESplineCoordinateSpace::Local, true);
+
+	ClimbTrigger = CreateDefaultSubobject<UBoxComponent>(TEXT("ClimbTrigger"));
+	ClimbTrigger->SetupAttachment(ClimbSpline);
+	ClimbTrigger->SetCollisionProfileName(UCollisionProfile::PawnOverlap_ProfileName);
+	ClimbTrigger->SetGenerateOverlapEvents(true);
+}
+
+void ASRS_ClimbableSplineActor::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	// Fit the trigger around the spline so it follows edits to the points
+	const FBox LocalBounds = ClimbSpline->CalcBounds(FTransform::Identity).GetBox();
+	ClimbTrigger->SetRelativeLocation(LocalBounds.GetCenter());
+	ClimbTrigger->SetBoxExtent(LocalBounds.GetExtent() + FVector(TriggerExtent));
+}
+
+void ASRS_ClimbableSplineActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ClimbTrigger->OnComponentBeginOverlap.AddDynamic(this, &ThisClass::OnTriggerBeginOverlap);
+	ClimbTrigger->OnComponentEndOverlap.AddDynamic(this, &ThisClass::OnTriggerEndOverlap);
+}
+
+float ASRS_ClimbableSplineActor::GetSplineLength() const
+{
+	return ClimbSpline->GetSplineLength();
+}
+
+float ASRS_ClimbableSplineActor::FindClosestDistance(const FVector& WorldLocation) const
+{
+	const float InputKey = ClimbSpline->FindInputKeyClosestToWorldLocation(WorldLocation);
+	return ClimbSpline->GetDistanceAlongSplineAtSplineInputKey(InputKey);
+}
+
+FTransform ASRS_ClimbableSplineActor::GetClimbTransform(float Distance) const
+{
+	const FVector SplineLocation = ClimbSpline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	const FVector SplineUp = ClimbSpline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	const FVector FaceNormal = ClimbSpline->GetUpVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	const FQuat ClimbRotation = FRotationMatrix::MakeFromXZ(-FaceNormal, SplineUp).ToQuat();
+	return FTransform(ClimbRotation, SplineLocation + FaceNormal * ClimbOffset);
+}
+
+void ASRS_ClimbableSplineActor::OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	const ACharacter* Character = Cast<ACharacter>(OtherActor);
+	if (!Character) { return; }
+	if (USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Character->GetCharacterMovement()))
+	{
+		Movement->SetClimbableSplineCandidate(this);
+	}
+}
+
+void ASRS_ClimbableSplineActor::OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	const ACharacter* Character = Cast<ACharacter>(OtherActor);
+	if (!Character) { return; }
+	if (USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Character->GetCharacterMovement()))
+	{
+		Movement->ClearClimbableSplineCandidate(this);
+	}
+}
@@ -0,0 +1,75 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Mass/SRS_ClimberFarRepresentation.h"
+
+#include "ClimbingSystem/Public/Mass/SRS_ClimberLODSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Net/UnrealNetwork.h"
+
+ASRS_ClimberFarRepresentation::ASRS_ClimberFarRepresentation()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	// Demoted climbers barely move, a few updates a second is plenty
+	NetUpdateFrequency = 4.f;
+
+	InstancedMesh = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("InstancedMesh"));
+	InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	InstancedMesh->SetCastShadow(false);
+	SetRootComponent(InstancedMesh);
+}
+
+void ASRS_ClimberFarRepresentation::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ASRS_ClimberFarRepresentation, ClimberInstances);
+}
+
+void ASRS_ClimberFarRepresentation::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The mesh comes from config so clients resolve the same one without it being replicated
+	InstancedMesh->SetStaticMesh(GetDefault<USRS_ClimberLODSubsystem>()->GetFarClimberMesh().LoadSynchronous());
+	UpdateInstances();
+}
+
+void ASRS_ClimberFarRepresentation::SetInstances(TArray<FSRS_FarClimberInstance>&& NewInstances)
+{
+	ClimberInstances = MoveTemp(NewInstances);
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		UpdateInstances();
+	}
+}
+
+void ASRS_ClimberFarRepresentation::OnRep_ClimberInstances()
+{
+	UpdateInstances();
+}
+
+void ASRS_ClimberFarRepresentation::UpdateInstances()
+{
+	if (!InstancedMesh->GetStaticMesh()) { return; }
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(ClimberInstances.Num());
+	for (const FSRS_FarClimberInstance& Instance : ClimberInstances)
+	{
+		Transforms.Emplace(FRotationMatrix::MakeFromX(Instance.Forward).ToQuat(), Instance.Location);
+	}
+
+	if (Transforms.Num() != InstancedMesh->GetInstanceCount())
+	{
+		InstancedMesh->ClearInstances();
+		InstancedMesh->AddInstances(Transforms, false, true);
+	}
+	else if (!Transforms.IsEmpty())
+	{
+		InstancedMesh->BatchUpdateInstancesTransforms(0, Transforms, true, true);
+	}
+}
@@ -0,0 +1,273 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Mass/SRS_ClimberLODSubsystem.h"
+
+#include "ClimbingSystem/Public/Characters/SRS_AIClimberCharacter.h"
+#include "ClimbingSystem/Public/Mass/SRS_ClimberFarRepresentation.h"
+#include "ClimbingSystem/Public/Mass/SRS_ClimberMassFragments.h"
+#include "ClimbingSystem/Public/Pooling/SRS_ClimberPoolSubsystem.h"
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "MassCommonFragments.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+
+void USRS_ClimberLODSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UMassEntitySubsystem* EntitySubsystem = InWorld.GetSubsystem<UMassEntitySubsystem>())
+	{
+		ClimberArchetype = EntitySubsystem->GetMutableEntityManager().CreateArchetype(
+		{
+			FTransformFragment::StaticStruct(),
+			FSRS_ClimbAnchorFragment::StaticStruct(),
+			FSRS_ClimberRepresentationFragment::StaticStruct()
+		});
+	}
+
+	// Clients get the far representation replicated from the server
+	if (!FarClimberMesh.IsNull() && InWorld.GetNetMode() != NM_Client)
+	{
+		FarRepresentation = InWorld.SpawnActor<ASRS_ClimberFarRepresentation>();
+	}
+}
+
+void USRS_ClimberLODSubsystem::Deinitialize()
+{
+	FullClimbers.Reset();
+	SimulatedClimbers.Reset();
+	SimulatedClimberClasses.Reset();
+	FarRepresentation = nullptr;
+	Super::Deinitialize();
+}
+
+void USRS_ClimberLODSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const UWorld* World = GetWorld();
+	if (!World || !World->HasBegunPlay() || World->GetNetMode() == NM_Client || !ClimberArchetype.IsValid()) { return; }
+
+	UpdateFarRepresentation();
+
+	TimeUntilLODUpdate -= DeltaTime;
+	if (TimeUntilLODUpdate > 0.f) { return; }
+	TimeUntilLODUpdate = LODUpdateInterval;
+
+	GatherViewLocations();
+	if (ViewLocations.IsEmpty()) { return; }
+
+	const float DemoteDistanceSquared = FMath::Square(DemoteDistance);
+	for (int32 Index = FullClimbers.Num() - 1; Index >= 0; --Index)
+	{
+		ACharacter* Climber = FullClimbers[Index];
+		if (CanDemote(Climber) && GetClosestViewDistanceSquared(Climber->GetActorLocation()) > DemoteDistanceSquared)
+		{
+			Demote(Climber);
+		}
+	}
+
+	const FMassEntityManager& EntityManager = World->GetSubsystem<UMassEntitySubsystem>()->GetEntityManager();
+	const float PromoteDistanceSquared = FMath::Square(PromoteDistance);
+	for (int32 Index = SimulatedClimbers.Num() - 1; Index >= 0; --Index)
+	{
+		const FVector Location = EntityManager.GetFragmentDataChecked<FTransformFragment>(SimulatedClimbers[Index]).GetTransform().GetLocation();
+		if (GetClosestViewDistanceSquared(Location) < PromoteDistanceSquared)
+		{
+			Promote(Index);
+		}
+	}
+}
+
+TStatId USRS_ClimberLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USRS_ClimberLODSubsystem, STATGROUP_Tickables);
+}
+
+void USRS_ClimberLODSubsystem::RegisterClimber(ACharacter* Climber)
+{
+	if (!Climber) { return; }
+	FullClimbers.AddUnique(Climber);
+}
+
+void USRS_ClimberLODSubsystem::UnregisterClimber(ACharacter* Climber)
+{
+	FullClimbers.RemoveSingleSwap(Climber);
+}
+
+bool USRS_ClimberLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USRS_ClimberLODSubsystem::GatherViewLocations()
+{
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		if (const APlayerController* PlayerController = Iterator->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+}
+
+float USRS_ClimberLODSubsystem::GetClosestViewDistanceSquared(const FVector& Location) const
+{
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, static_cast<float>(FVector::DistSquared(Location, ViewLocation)));
+	}
+	return ClosestDistanceSquared;
+}
+
+bool USRS_ClimberLODSubsystem::CanDemote(const ACharacter* Climber) const
+{
+	if (!IsValid(Climber) || Climber->IsPlayerControlled()) { return false; }
+	const USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Climber->GetCharacterMovement());
+	// Spline climbers and ledge hangers are cheap already and their spline or ledge is not carried in the climb state
+	if (!Movement || !Movement->IsClimbing() || Movement->IsSplineClimbing() || Movement->IsLedgeHanging()) { return false; }
+	if (Movement->HasActiveBakedTrack()) { return false; }
+	const UAnimInstance* AnimInstance = Climber->GetMesh() ? Climber->GetMesh()->GetAnimInstance() : nullptr;
+	return !AnimInstance || !AnimInstance->IsAnyMontagePlaying();
+}
+
+void USRS_ClimberLODSubsystem::Demote(ACharacter* Climber)
+{
+	USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Climber->GetCharacterMovement());
+	const FSRS_ClimbState State = Movement->ExportClimbState();
+
+	FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	const FMassEntityHandle Entity = EntityManager.CreateEntity(ClimberArchetype);
+	EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(FTransform(State.Rotation, State.Location));
+
+	FSRS_ClimbAnchorFragment& Anchor = EntityManager.GetFragmentDataChecked<FSRS_ClimbAnchorFragment>(Entity);
+	Anchor.SurfaceLocation = State.SurfaceLocation;
+	Anchor.SurfaceNormal = State.SurfaceNormal;
+	Anchor.Velocity = State.Velocity;
+	Anchor.PlaneOffset = FVector::DotProduct(State.Location - State.SurfaceLocation, State.SurfaceNormal);
+	Anchor.BrakingDeceleration = Movement->GetMaxBreakClimbDeceleration();
+	Anchor.MovementMode = State.MovementMode;
+	Anchor.CustomMovementMode = State.CustomMovementMode;
+	if (const UPrimitiveComponent* Surface = State.SurfaceComponent.Get())
+	{
+		Anchor.ClimbBounds = Surface->Bounds.GetBox().ExpandBy(Climber->GetSimpleCollisionRadius() * 2.f);
+	}
+
+	FSRS_ClimberRepresentationFragment& Representation = EntityManager.GetFragmentDataChecked<FSRS_ClimberRepresentationFragment>(Entity);
+	Representation.CharacterClass = Climber->GetClass();
+	SimulatedClimberClasses.Add(Climber->GetClass());
+	SimulatedClimbers.Add(Entity);
+
+	// Keep the controller, unpossessed, for whichever character the climber is promoted into
+	if (AController* Controller = Climber->GetController())
+	{
+		Controller->StopMovement();
+		Controller->UnPossess();
+		Representation.Controller = Controller;
+	}
+
+	USRS_ClimberPoolSubsystem* ClimberPool = GetWorld()->GetSubsystem<USRS_ClimberPoolSubsystem>();
+	if (ASRS_AIClimberCharacter* AIClimber = Cast<ASRS_AIClimberCharacter>(Climber); AIClimber && ClimberPool)
+	{
+		ClimberPool->ReleaseClimber(AIClimber);
+		return;
+	}
+	Climber->Destroy();
+}
+
+void USRS_ClimberLODSubsystem::Promote(int32 SimulatedIndex)
+{
+	UWorld* World = GetWorld();
+	FMassEntityManager& EntityManager = World->GetSubsystem<UMassEntitySubsystem>()->GetMutableEntityManager();
+	const FMassEntityHandle Entity = SimulatedClimbers[SimulatedIndex];
+	SimulatedClimbers.RemoveAtSwap(SimulatedIndex);
+
+	const FTransform& Transform = EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).GetTransform();
+	const FSRS_ClimbAnchorFragment& Anchor = EntityManager.GetFragmentDataChecked<FSRS_ClimbAnchorFragment>(Entity);
+	FSRS_ClimbState State;
+	State.Location = Transform.GetLocation();
+	State.Rotation = Transform.GetRotation();
+	State.Velocity = Anchor.Velocity;
+	State.SurfaceLocation = Anchor.SurfaceLocation;
+	State.SurfaceNormal = Anchor.SurfaceNormal;
+	State.MovementMode = Anchor.MovementMode;
+	State.CustomMovementMode = Anchor.CustomMovementMode;
+
+	const FSRS_ClimberRepresentationFragment& Representation = EntityManager.GetFragmentDataChecked<FSRS_ClimberRepresentationFragment>(Entity);
+	const TSubclassOf<ACharacter> CharacterClass = Representation.CharacterClass;
+	AController* Controller = Representation.Controller.Get();
+	EntityManager.DestroyEntity(Entity);
+	if (!CharacterClass)
+	{
+		if (Controller)
+		{
+			Controller->Destroy();
+		}
+		return;
+	}
+
+	const FTransform SpawnTransform(State.Rotation, State.Location);
+	ACharacter* Climber = nullptr;
+	USRS_ClimberPoolSubsystem* ClimberPool = World->GetSubsystem<USRS_ClimberPoolSubsystem>();
+	if (ClimberPool && CharacterClass->IsChildOf<ASRS_AIClimberCharacter>())
+	{
+		Climber = ClimberPool->AcquireClimber(CharacterClass.Get(), SpawnTransform, Controller);
+	}
+	else
+	{
+		Climber = SpawnClimber(CharacterClass, SpawnTransform, Controller);
+	}
+	if (!Climber) { return; }
+	if (!Climber->GetController())
+	{
+		Climber->SpawnDefaultController();
+	}
+	if (USRS_MovementComponent* Movement = Cast<USRS_MovementComponent>(Climber->GetCharacterMovement()))
+	{
+		Movement->ImportClimbState(State);
+	}
+}
+
+ACharacter* USRS_ClimberLODSubsystem::SpawnClimber(TSubclassOf<ACharacter> CharacterClass, const FTransform& SpawnTransform, AController* Controller) const
+{
+	ACharacter* Climber = GetWorld()->SpawnActorDeferred<ACharacter>(CharacterClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Climber) { return nullptr; }
+
+	// Skip the auto-possess controller when the demoted one is handed back
+	if (Controller)
+	{
+		Climber->AutoPossessAI = EAutoPossessAI::Disabled;
+	}
+	Climber->FinishSpawning(SpawnTransform);
+	if (Controller)
+	{
+		Controller->Possess(Climber);
+	}
+	return Climber;
+}
+
+void USRS_ClimberLODSubsystem::UpdateFarRepresentation()
+{
+	if (!FarRepresentation) { return; }
+
+	const FMassEntityManager& EntityManager = GetWorld()->GetSubsystem<UMassEntitySubsystem>()->GetEntityManager();
+	TArray<FSRS_FarClimberInstance> Instances;
+	Instances.Reserve(SimulatedClimbers.Num());
+	for (const FMassEntityHandle& Entity : SimulatedClimbers)
+	{
+		const FTransform& Transform = EntityManager.GetFragmentDataChecked<FTransformFragment>(Entity).GetTransform();
+		FSRS_FarClimberInstance& Instance = Instances.AddDefaulted_GetRef();
+		Instance.Location = Transform.GetLocation();
+		Instance.Forward = Transform.GetRotation().GetForwardVector();
+	}
+	FarRepresentation->SetInstances(MoveTemp(Instances));
+}
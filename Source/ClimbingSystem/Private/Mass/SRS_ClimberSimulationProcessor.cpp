@@ -0,0 +1,58 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Mass/SRS_ClimberSimulationProcessor.h"
+
+#include "ClimbingSystem/Public/Mass/SRS_ClimberMassFragments.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+
+USRS_ClimberSimulationProcessor::USRS_ClimberSimulationProcessor()
+	: EntityQuery(*this)
+{
+	bAutoRegisterWithProcessingPhases = true;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void USRS_ClimberSimulationProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FSRS_ClimbAnchorFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void USRS_ClimberSimulationProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [](FMassExecutionContext& Context)
+	{
+		const float DeltaTime = Context.GetDeltaTimeSeconds();
+		const TArrayView<FSRS_ClimbAnchorFragment> Anchors = Context.GetMutableFragmentView<FSRS_ClimbAnchorFragment>();
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+
+		for (int32 Index = 0; Index < Context.GetNumEntities(); ++Index)
+		{
+			FSRS_ClimbAnchorFragment& Anchor = Anchors[Index];
+			FTransform& Transform = Transforms[Index].GetMutableTransform();
+
+			// Brake the climber to a stop in the wall plane at its recorded stand-off instead of sliding it on forever
+			Anchor.Velocity = FVector::VectorPlaneProject(Anchor.Velocity, Anchor.SurfaceNormal);
+			if (Anchor.Velocity.IsNearlyZero()) { continue; }
+			const float Speed = Anchor.Velocity.Size();
+			const float BrakedSpeed = Anchor.BrakingDeceleration > 0.f ? FMath::Max(Speed - Anchor.BrakingDeceleration * DeltaTime, 0.f) : 0.f;
+			Anchor.Velocity *= BrakedSpeed / Speed;
+			FVector Location = Transform.GetLocation() + Anchor.Velocity * DeltaTime;
+			const float Offset = FVector::DotProduct(Location - Anchor.SurfaceLocation, Anchor.SurfaceNormal);
+			Location -= Anchor.SurfaceNormal * (Offset - Anchor.PlaneOffset);
+
+			if (Anchor.ClimbBounds.IsValid && !Anchor.ClimbBounds.IsInsideOrOn(Location))
+			{
+				Location = Anchor.ClimbBounds.GetClosestPointTo(Location);
+				Anchor.Velocity = FVector::ZeroVector;
+			}
+
+			Anchor.SurfaceLocation += FVector::VectorPlaneProject(Location - Transform.GetLocation(), Anchor.SurfaceNormal);
+			Transform.SetLocation(Location);
+		}
+	});
+}
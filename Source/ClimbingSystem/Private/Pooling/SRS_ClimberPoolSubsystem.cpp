@@ -0,0 +1,85 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Pooling/SRS_ClimberPoolSubsystem.h"
+
+#include "ClimbingSystem/Public/Characters/SRS_AIClimberCharacter.h"
+#include "ClimbingSystem/Public/Mass/SRS_ClimberLODSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+
+ASRS_AIClimberCharacter* USRS_ClimberPoolSubsystem::AcquireClimber(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass, const FTransform& SpawnTransform, AController* Controller)
+{
+	if (!ClimberClass) { return nullptr; }
+
+	if (FSRS_ClimberPoolBucket* Bucket = Pools.Find(ClimberClass))
+	{
+		while (!Bucket->Climbers.IsEmpty())
+		{
+			ASRS_AIClimberCharacter* Climber = Bucket->Climbers.Pop(EAllowShrinking::No);
+			if (!IsValid(Climber)) { continue; }
+			Climber->OnAcquiredFromPool(SpawnTransform, Controller);
+			if (USRS_ClimberLODSubsystem* ClimberLOD = GetWorld()->GetSubsystem<USRS_ClimberLODSubsystem>())
+			{
+				ClimberLOD->RegisterClimber(Climber);
+			}
+			return Climber;
+		}
+	}
+
+	ASRS_AIClimberCharacter* Climber = GetWorld()->SpawnActorDeferred<ASRS_AIClimberCharacter>(ClimberClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Climber) { return nullptr; }
+	if (Controller)
+	{
+		Climber->AutoPossessAI = EAutoPossessAI::Disabled;
+	}
+	Climber->FinishSpawning(SpawnTransform);
+	if (Controller)
+	{
+		Controller->Possess(Climber);
+	}
+	return Climber;
+}
+
+void USRS_ClimberPoolSubsystem::ReleaseClimber(ASRS_AIClimberCharacter* Climber)
+{
+	if (!IsValid(Climber) || Climber->IsPooled()) { return; }
+
+	FSRS_ClimberPoolBucket& Bucket = Pools.FindOrAdd(Climber->GetClass());
+	if (Bucket.Climbers.Num() >= MaxPooledPerClass)
+	{
+		Climber->Destroy();
+		return;
+	}
+
+	if (USRS_ClimberLODSubsystem* ClimberLOD = GetWorld()->GetSubsystem<USRS_ClimberLODSubsystem>())
+	{
+		ClimberLOD->UnregisterClimber(Climber);
+	}
+	Climber->OnReturnedToPool();
+	Bucket.Climbers.Add(Climber);
+}
+
+void USRS_ClimberPoolSubsystem::Prewarm(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass, int32 Count)
+{
+	if (!ClimberClass) { return; }
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	const int32 NumToSpawn = FMath::Min(Count, MaxPooledPerClass) - GetNumPooled(ClimberClass);
+	for (int32 Index = 0; Index < NumToSpawn; ++Index)
+	{
+		ReleaseClimber(GetWorld()->SpawnActor<ASRS_AIClimberCharacter>(ClimberClass, FTransform::Identity, SpawnParameters));
+	}
+}
+
+int32 USRS_ClimberPoolSubsystem::GetNumPooled(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass) const
+{
+	const FSRS_ClimberPoolBucket* Bucket = Pools.Find(ClimberClass);
+	return Bucket ? Bucket->Climbers.Num() : 0;
+}
+
+bool USRS_ClimberPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
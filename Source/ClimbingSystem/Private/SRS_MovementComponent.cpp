@@ -4,12 +4,70 @@
 #include "ClimbingSystem/Public/SRS_MovementComponent.h"
 
 #include "MotionWarpingComponent.h"
-#include "ClimbingSystem/ClimbingSystemCharacter.h"
+#include "ClimbingSystem/ClimbingSystem.h"
+#include "ClimbingSystem/Public/Characters/SRS_ClimberCharacter.h"
 #include "GameFramework/Character.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "ClimbingSystem/Debugger/DebugHelper.h"
 #include "Components/CapsuleComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "ClimbingSystem/Public/Math/SRS_ClimbKernels.h"
+#include "ClimbingSystem/Public/Telemetry/SRS_ClimbHeatmapSubsystem.h"
+#include "ClimbingSystem/Public/Telemetry/SRS_ClimbTelemetry.h"
+#include "ClimbingSystem/Public/Telemetry/SRS_ClimbTelemetrySubsystem.h"
+#include "ClimbingSystem/Public/Mass/SRS_ClimberLODSubsystem.h"
+#include "ClimbingSystem/Public/Animation/SRS_BakedRootMotion.h"
+#include "ClimbingSystem/Public/Animation/SRS_ClimbMontageSet.h"
+#include "ClimbingSystem/Public/Climbables/SRS_ClimbableSplineActor.h"
+#include "ClimbingSystem/Public/Climbables/SRS_ClimbabilitySet.h"
+#include "ClimbingSystem/Public/Avoidance/SRS_ClimberSpacingSubsystem.h"
+#include "ClimbingSystem/Public/Validation/SRS_ClimbValidationSubsystem.h"
+
+namespace
+{
+	SRS::ClimbKernels::FVec3 ToKernel(const FVector& Vector)
+	{
+		return { Vector.X, Vector.Y, Vector.Z };
+	}
+
+	FVector FromKernel(const SRS::ClimbKernels::FVec3& Vector)
+	{
+		return FVector(Vector.X, Vector.Y, Vector.Z);
+	}
+
+	// The snap stops this far short of the wall so the sweep ending there does not report it as a blocking hit
+	constexpr float ClimbSnapSkin = 1.f;
+
+	// Swept moves PhysClimbing issued across all climbers since the last srs.Climb.SweepStats
+	int64 ClimbSweeps = 0;
+	int64 ClimbSweepTicks = 0;
+}
+
+static TAutoConsoleVariable<bool> CVarForceBakedRootMotion(
+	TEXT("srs.BakedRootMotion.Force"),
+	false,
+	TEXT("Play baked climb root motion in every net mode instead of only on dedicated servers, for validating baked tracks."));
+
+static TAutoConsoleVariable<bool> CVarClimbFusedMove(
+	TEXT("srs.Climb.FusedMove"),
+	true,
+	TEXT("Fold the surface snap into the climb move so each tick issues one swept move. Disable to compare against the separate snap move."));
+
+static FAutoConsoleCommand ClimbSweepStatsCommand(
+	TEXT("srs.Climb.SweepStats"),
+	TEXT("Log the swept moves per climb tick since the last call, then reset the count. Compare with srs.Climb.FusedMove 0 and 1."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UE_LOG(LogClimbingSystem, Log, TEXT("Climb sweeps: %lld over %lld climb ticks, %.2f per tick (fused move %s)"),
+			ClimbSweeps, ClimbSweepTicks, ClimbSweepTicks > 0 ? static_cast<double>(ClimbSweeps) / ClimbSweepTicks : 0.0,
+			CVarClimbFusedMove.GetValueOnGameThread() ? TEXT("on") : TEXT("off"));
+		ClimbSweeps = 0;
+		ClimbSweepTicks = 0;
+	}));
 
 TArray<FHitResult> USRS_MovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End,
                                                                        bool bShowShape, bool bDrawPersistent)
@@ -20,6 +78,7 @@ TArray<FHitResult> USRS_MovementComponent::DoCapsuleTraceMultiByObject(const FVe
 	{
 		DrawDebugType = bDrawPersistent ? EDrawDebugTrace::Persistent : EDrawDebugTrace::ForOneFrame;
 	}
+	const uint64 StartCycles = ClimbHeatmap ? FPlatformTime::Cycles64() : 0;
 	UKismetSystemLibrary::CapsuleTraceMultiForObjects
 	(
 		this,
@@ -34,6 +93,10 @@ TArray<FHitResult> USRS_MovementComponent::DoCapsuleTraceMultiByObject(const FVe
 		Hits,
 		false
 	);
+	if (ClimbHeatmap)
+	{
+		ClimbHeatmap->RecordTrace(Start, Hits.Num(), FPlatformTime::Cycles64() - StartCycles);
+	}
 	return Hits;
 }
 
@@ -46,6 +109,7 @@ FHitResult USRS_MovementComponent::DoLineTraceSingleByObject(const FVector& Star
 	{
 		DrawDebugType = bDrawPersistent ? EDrawDebugTrace::Persistent : EDrawDebugTrace::ForOneFrame;
 	}
+	const uint64 StartCycles = ClimbHeatmap ? FPlatformTime::Cycles64() : 0;
 	UKismetSystemLibrary::LineTraceSingleForObjects
 	(
 		this,
@@ -58,6 +122,10 @@ FHitResult USRS_MovementComponent::DoLineTraceSingleByObject(const FVector& Star
 		Hit,
 		false
 	);
+	if (ClimbHeatmap)
+	{
+		ClimbHeatmap->RecordTrace(Start, Hit.bBlockingHit ? 1 : 0, FPlatformTime::Cycles64() - StartCycles);
+	}
 	return Hit;
 }
 
@@ -66,10 +134,168 @@ FVector USRS_MovementComponent::GetUnrotatedClimbVelocity() const
 	return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Velocity);
 }
 
+float USRS_MovementComponent::PredictClimbStopDistance() const
+{
+	// Spline climbing and ledge hanging stop dead when input is released, only free climbing brakes
+	if (MovementMode != MOVE_Custom || CustomMovementMode != ECustomMovementMode::MOVE_Climb) { return 0.f; }
+	if (MaxBreakClimbDeceleration <= 0.f) { return 0.f; }
+	const float SpeedSquared = FVector::VectorPlaneProject(Velocity, CurrentClimbableSurfaceNormal).SizeSquared();
+	return SpeedSquared / (2.f * MaxBreakClimbDeceleration);
+}
+
+FSRS_ClimbState USRS_MovementComponent::ExportClimbState() const
+{
+	FSRS_ClimbState State;
+	State.Location = UpdatedComponent->GetComponentLocation();
+	State.Rotation = UpdatedComponent->GetComponentQuat();
+	State.Velocity = Velocity;
+	State.SurfaceLocation = CurrentClimbableSurfaceLocation;
+	State.SurfaceNormal = CurrentClimbableSurfaceNormal;
+	State.SurfaceComponent = ClimbBaseComponent;
+	State.MovementMode = MovementMode;
+	State.CustomMovementMode = CustomMovementMode;
+	return State;
+}
+
+void USRS_MovementComponent::ImportClimbState(const FSRS_ClimbState& State)
+{
+	UpdatedComponent->SetWorldLocationAndRotation(State.Location, State.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	CurrentClimbableSurfaceLocation = State.SurfaceLocation;
+	CurrentClimbableSurfaceNormal = State.SurfaceNormal;
+	ClearClimbAnchor();
+	SetMovementMode(State.MovementMode, State.CustomMovementMode);
+	Velocity = State.Velocity;
+}
+
+void USRS_MovementComponent::ResetClimbState()
+{
+	if (IsClimbing())
+	{
+		StopClimbing();
+	}
+	StopMovementImmediately();
+	ClimbableSurfacesHits.Reset();
+	CurrentClimbableSurfaceLocation = FVector::ZeroVector;
+	CurrentClimbableSurfaceNormal = FVector::ZeroVector;
+	ClearClimbAnchor();
+	ClimbableSplineCandidate.Reset();
+	ActiveBakedTrack = nullptr;
+	BakedTrackTime = 0.f;
+	AbortedClimbMontage.Reset();
+	ReleaseClimbMontages();
+	NumClimbCommands = 0;
+	bClimbInputWindowOpen = false;
+	bClimbCancelWindowOpen = false;
+	PendingTelemetryEvents = 0;
+}
+
+void USRS_MovementComponent::RegisterCustomMovementMode(uint8 Mode, const FSRS_CustomMovementModeEntry& Entry)
+{
+	if (Mode >= CustomMovementModes.Num())
+	{
+		CustomMovementModes.SetNum(Mode + 1);
+	}
+	CustomMovementModes[Mode] = Entry;
+}
+
+const FSRS_CustomMovementModeEntry* USRS_MovementComponent::FindCustomMovementMode(uint8 Mode) const
+{
+	return CustomMovementModes.IsValidIndex(Mode) && CustomMovementModes[Mode].Phys ? &CustomMovementModes[Mode] : nullptr;
+}
+
+const FSRS_CustomMovementModeEntry* USRS_MovementComponent::GetActiveCustomMovementMode() const
+{
+	return MovementMode == MOVE_Custom ? FindCustomMovementMode(CustomMovementMode) : nullptr;
+}
+
+void USRS_MovementComponent::RegisterCustomMovementModes()
+{
+	CustomMovementModes.Reset();
+	CustomMovementModes.SetNum(ECustomMovementMode::MOVE_Max);
+
+	FSRS_CustomMovementModeEntry Climb;
+	Climb.Phys = &ThisClass::PhysClimbing;
+	Climb.OnEnter = &ThisClass::OnEnterClimbing;
+	Climb.OnExit = &ThisClass::OnExitClimbing;
+	Climb.MaxSpeed = MaxClimbSpeed;
+	Climb.MaxAcceleration = MaxClimbAcceleration;
+	RegisterCustomMovementMode(ECustomMovementMode::MOVE_Climb, Climb);
+
+	FSRS_CustomMovementModeEntry SplineClimb;
+	SplineClimb.Phys = &ThisClass::PhysSplineClimbing;
+	SplineClimb.OnEnter = &ThisClass::OnEnterSplineClimbing;
+	SplineClimb.OnExit = &ThisClass::OnExitSplineClimbing;
+	SplineClimb.MaxSpeed = MaxClimbSpeed;
+	SplineClimb.MaxAcceleration = MaxClimbAcceleration;
+	SplineClimb.State.Emplace<FSRS_SplineClimbModeState>();
+	RegisterCustomMovementMode(ECustomMovementMode::MOVE_SplineClimb, SplineClimb);
+
+	FSRS_CustomMovementModeEntry LedgeHang;
+	LedgeHang.Phys = &ThisClass::PhysLedgeHang;
+	LedgeHang.OnEnter = &ThisClass::OnEnterLedgeHang;
+	LedgeHang.OnExit = &ThisClass::OnExitLedgeHang;
+	LedgeHang.MaxSpeed = MaxLedgeShimmySpeed;
+	LedgeHang.MaxAcceleration = MaxClimbAcceleration;
+	LedgeHang.State.Emplace<FSRS_LedgeHangModeState>();
+	RegisterCustomMovementMode(ECustomMovementMode::MOVE_LedgeHang, LedgeHang);
+
+	ApplyClimbabilityClass(CurrentClimbabilityClassId);
+}
+
+const FSRS_ClimbabilityClass& USRS_MovementComponent::GetClimbabilityClass(uint8 ClassId) const
+{
+	static const FSRS_ClimbabilityClass DefaultClimbabilityClass;
+	return Climbability ? Climbability->GetClass(ClassId) : DefaultClimbabilityClass;
+}
+
+uint8 USRS_MovementComponent::GetClimbabilityClassId(UPrimitiveComponent* Component)
+{
+	if (!Climbability || !Component) { return 0; }
+	if (const uint8* ClassId = ClimbabilityCache.Find(Component))
+	{
+		return *ClassId;
+	}
+	// Stale entries of destroyed primitives are only ever dropped wholesale
+	if (ClimbabilityCache.Num() >= MaxCachedClimbabilityClasses)
+	{
+		ClimbabilityCache.Reset();
+	}
+	const uint8 ClassId = Climbability->ResolveClassId(Component);
+	ClimbabilityCache.Add(Component, ClassId);
+	return ClassId;
+}
+
+bool USRS_MovementComponent::IsClimbMoveAllowed(ESRS_ClimbMove Move) const
+{
+	return GetClimbabilityClass(CurrentClimbabilityClassId).AllowsMove(Move);
+}
+
+bool USRS_MovementComponent::IsClimbMoveAllowedOn(UPrimitiveComponent* Component, ESRS_ClimbMove Move)
+{
+	return GetClimbabilityClass(GetClimbabilityClassId(Component)).AllowsMove(Move);
+}
+
+void USRS_MovementComponent::ApplyClimbabilityClass(uint8 ClassId)
+{
+	CurrentClimbabilityClassId = ClassId;
+	const FSRS_ClimbabilityClass& Class = GetClimbabilityClass(ClassId);
+	CurrentCosMaxFloorAngle = FMath::Cos(FMath::DegreesToRadians(Class.MaxFloorAngle));
+	// Spline climbers follow authored geometry and keep the unscaled limits
+	for (const uint8 Mode : { static_cast<uint8>(ECustomMovementMode::MOVE_Climb), static_cast<uint8>(ECustomMovementMode::MOVE_LedgeHang) })
+	{
+		if (!CustomMovementModes.IsValidIndex(Mode)) { continue; }
+		FSRS_CustomMovementModeEntry& Entry = CustomMovementModes[Mode];
+		Entry.MaxSpeed = (Mode == ECustomMovementMode::MOVE_LedgeHang ? MaxLedgeShimmySpeed : MaxClimbSpeed) * Class.SpeedMultiplier;
+		Entry.MaxAcceleration = MaxClimbAcceleration * Class.AccelerationMultiplier;
+	}
+}
+
 void USRS_MovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	RegisterCustomMovementModes();
+
 	OwningPlayerAnimInstance = CharacterOwner->GetMesh()->GetAnimInstance();
 	if (OwningPlayerAnimInstance)
 	{
@@ -77,59 +303,348 @@ void USRS_MovementComponent::BeginPlay()
 		OwningPlayerAnimInstance->OnMontageBlendingOut.AddDynamic(this, &ThisClass::OnClimbMontageEnded);
 	}
 
-	OwningClimbingCharacter = Cast<AClimbingSystemCharacter>(CharacterOwner);
+	OwningClimbingCharacter = Cast<ASRS_ClimberCharacter>(CharacterOwner);
+
+	// With every climb montage baked the server never needs to evaluate the mesh or load the montages
+	bBakedRootMotionOnly = IsNetMode(NM_DedicatedServer) && BakedRootMotion && ClimbMontages && BakedRootMotion->HasTracksFor(ClimbMontages->GetMontagePaths());
+	if (bBakedRootMotionOnly)
+	{
+		CharacterOwner->GetMesh()->SetComponentTickEnabled(false);
+	}
+
+	if (USRS_ClimbTelemetrySubsystem* Telemetry = GetWorld()->GetSubsystem<USRS_ClimbTelemetrySubsystem>())
+	{
+		TelemetryStream = Telemetry->RegisterClimber();
+	}
+
+	USRS_ClimbHeatmapSubsystem* Heatmap = GetWorld()->GetSubsystem<USRS_ClimbHeatmapSubsystem>();
+	ClimbHeatmap = Heatmap && Heatmap->IsRecording() ? Heatmap : nullptr;
+
+	if (USRS_ClimberLODSubsystem* ClimberLOD = GetWorld()->GetSubsystem<USRS_ClimberLODSubsystem>())
+	{
+		ClimberLOD->RegisterClimber(CharacterOwner);
+	}
+
+	ClimberSpacing = GetWorld()->GetSubsystem<USRS_ClimberSpacingSubsystem>();
+	ClimbValidation = GetOwnerRole() == ROLE_Authority ? GetWorld()->GetSubsystem<USRS_ClimbValidationSubsystem>() : nullptr;
+}
+
+void USRS_MovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USRS_ClimbTelemetrySubsystem* Telemetry = GetWorld()->GetSubsystem<USRS_ClimbTelemetrySubsystem>())
+	{
+		Telemetry->UnregisterClimber(TelemetryStream);
+	}
+	TelemetryStream.Reset();
+	ReleaseClimbMontages();
+	if (ClimberSpacing)
+	{
+		ClimberSpacing->UnregisterClimber(this);
+	}
+	if (USRS_ClimberLODSubsystem* ClimberLOD = GetWorld()->GetSubsystem<USRS_ClimberLODSubsystem>())
+	{
+		ClimberLOD->UnregisterClimber(CharacterOwner);
+	}
+	Super::EndPlay(EndPlayReason);
 }
 
 void USRS_MovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
                                            FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	UpdateClimbMontagePreload(DeltaTime);
+	if (NumClimbCommands > 0)
+	{
+		ProcessClimbCommands();
+	}
+	if (TelemetryStream)
+	{
+		RecordTelemetrySample();
+	}
+}
+
+void USRS_MovementComponent::QueueClimbCommand(ESRS_ClimbCommandType Type)
+{
+	if (NumClimbCommands == ClimbCommandCapacity)
+	{
+		PopClimbCommand();
+	}
+	FSRS_ClimbCommand& Command = ClimbCommands[(ClimbCommandHead + NumClimbCommands) % ClimbCommandCapacity];
+	Command.Type = Type;
+	Command.InputDirection = GetLastInputVector();
+	Command.ExpireTime = GetWorld()->GetTimeSeconds() + ClimbCommandBufferTime;
+	++NumClimbCommands;
+
+	// Nothing in the way runs the press straight away
+	ProcessClimbCommands();
+}
+
+void USRS_MovementComponent::SetClimbInputWindowOpen(bool bOpen)
+{
+	if (bClimbInputWindowOpen && !bOpen)
+	{
+		// Presses held by the window get the usual buffer time from its end
+		const double ExpireTime = GetWorld()->GetTimeSeconds() + ClimbCommandBufferTime;
+		for (int32 Index = 0; Index < NumClimbCommands; ++Index)
+		{
+			ClimbCommands[(ClimbCommandHead + Index) % ClimbCommandCapacity].ExpireTime = ExpireTime;
+		}
+	}
+	bClimbInputWindowOpen = bOpen;
+}
+
+void USRS_MovementComponent::SetClimbCancelWindowOpen(bool bOpen)
+{
+	bClimbCancelWindowOpen = bOpen;
+	if (bOpen && NumClimbCommands > 0)
+	{
+		ProcessClimbCommands();
+	}
+}
+
+void USRS_MovementComponent::ProcessClimbCommands()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	while (NumClimbCommands > 0)
+	{
+		const FSRS_ClimbCommand Command = ClimbCommands[ClimbCommandHead];
+		if (!bClimbInputWindowOpen && Now > Command.ExpireTime)
+		{
+			PopClimbCommand();
+			continue;
+		}
+		if (IsClimbMontageActive())
+		{
+			if (!bClimbCancelWindowOpen || ActiveBakedTrack) { return; }
+			CancelClimbMontage();
+		}
+		PopClimbCommand();
+		ExecuteClimbCommand(Command);
+	}
+}
+
+void USRS_MovementComponent::ExecuteClimbCommand(const FSRS_ClimbCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case ESRS_ClimbCommandType::StartClimb:
+		if (!IsClimbing())
+		{
+			ToggleClimbing(true);
+		}
+		break;
+	case ESRS_ClimbCommandType::StopClimb:
+		if (IsClimbing())
+		{
+			ToggleClimbing(false);
+		}
+		break;
+	case ESRS_ClimbCommandType::Hop:
+		if (IsClimbing())
+		{
+			RequestHop(Command.InputDirection);
+		}
+		break;
+	}
+}
+
+void USRS_MovementComponent::PopClimbCommand()
+{
+	ClimbCommandHead = (ClimbCommandHead + 1) % ClimbCommandCapacity;
+	--NumClimbCommands;
+}
+
+void USRS_MovementComponent::CancelClimbMontage()
+{
+	bClimbInputWindowOpen = false;
+	bClimbCancelWindowOpen = false;
+	if (OwningPlayerAnimInstance)
+	{
+		OwningPlayerAnimInstance->Montage_Stop(0.1f);
+	}
+}
+
+void USRS_MovementComponent::UpdateClimbMontagePreload(float DeltaTime)
+{
+	if (!ClimbMontages || bBakedRootMotionOnly) { return; }
+	ClimbPreloadProbeTimer -= DeltaTime;
+	if (ClimbPreloadProbeTimer > 0.f) { return; }
+	ClimbPreloadProbeTimer = ClimbPreloadProbeInterval;
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (IsClimbing() || ClimbPreloadRegionCount > 0 || IsClimbableGeometryNearby())
+	{
+		LastClimbableNearbyTime = Now;
+		RequestClimbMontagePreload();
+	}
+	else if (ClimbMontageHandle && Now - LastClimbableNearbyTime > ClimbMontageReleaseDelay && !IsPlayingClimbMontage())
+	{
+		ReleaseClimbMontages();
+	}
+}
+
+bool USRS_MovementComponent::IsClimbableGeometryNearby() const
+{
+	if (ClimbableSplineCandidate.IsValid()) { return true; }
+	FCollisionObjectQueryParams ObjectQueryParams;
+	for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : ClimbObjectTypes)
+	{
+		ObjectQueryParams.AddObjectTypesToQuery(UEngineTypes::ConvertToCollisionChannel(ObjectType));
+	}
+	if (!ObjectQueryParams.IsValid()) { return false; }
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbPreloadProbe), false, CharacterOwner);
+	return GetWorld()->OverlapAnyTestByObjectType
+	(
+		UpdatedComponent->GetComponentLocation(),
+		FQuat::Identity,
+		ObjectQueryParams,
+		FCollisionShape::MakeSphere(ClimbPreloadRadius),
+		QueryParams
+	);
+}
+
+void USRS_MovementComponent::RequestClimbMontagePreload()
+{
+	if (!ClimbMontages || ClimbMontageHandle.IsValid()) { return; }
+	ClimbMontageHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ClimbMontages->GetMontagePaths(), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void USRS_MovementComponent::ReleaseClimbMontages()
+{
+	if (!ClimbMontageHandle.IsValid()) { return; }
+	ClimbMontageHandle->ReleaseHandle();
+	ClimbMontageHandle.Reset();
+}
+
+void USRS_MovementComponent::EnterClimbPreloadRegion()
+{
+	++ClimbPreloadRegionCount;
+	RequestClimbMontagePreload();
+}
+
+void USRS_MovementComponent::ExitClimbPreloadRegion()
+{
+	ClimbPreloadRegionCount = FMath::Max(ClimbPreloadRegionCount - 1, 0);
+}
+
+void USRS_MovementComponent::RecordTelemetrySample()
+{
+	FSRS_ClimbTelemetrySample Sample;
+	Sample.Frame = static_cast<uint32>(GFrameCounter);
+	Sample.TimeMs = static_cast<uint32>(GetWorld()->GetTimeSeconds() * 1000.0);
+	Sample.MovementMode = MovementMode;
+	Sample.CustomMovementMode = CustomMovementMode;
+	Sample.Events = PendingTelemetryEvents;
+	Sample.Location = FVector3f(UpdatedComponent->GetComponentLocation());
+	Sample.Velocity = FVector3f(Velocity);
+	Sample.SurfaceNormal = FVector3f(CurrentClimbableSurfaceNormal);
+	TelemetryStream->Push(Sample);
+	PendingTelemetryEvents = 0;
+}
+
+void USRS_MovementComponent::MarkTelemetryEvent(ESRS_ClimbTelemetryEvent Event)
+{
+	PendingTelemetryEvents |= static_cast<uint8>(Event);
+}
+
+void USRS_MovementComponent::RecordHeatmapEvent(ESRS_ClimbHeatmapEvent Event)
+{
+	if (!ClimbHeatmap) { return; }
+	ClimbHeatmap->RecordEvent(UpdatedComponent->GetComponentLocation(), Event);
 }
 
 void USRS_MovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
-	if (IsClimbing())
+	const FSRS_CustomMovementModeEntry* PreviousMode = PreviousMovementMode == MOVE_Custom ? FindCustomMovementMode(PreviousCustomMode) : nullptr;
+	if (PreviousMode && PreviousMode->OnExit)
 	{
-		bOrientRotationToMovement = false;
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(48.f);
-		OnEnterClimbState.ExecuteIfBound();
+		(this->*PreviousMode->OnExit)();
 	}
-	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Climb)
+	const FSRS_CustomMovementModeEntry* ActiveMode = GetActiveCustomMovementMode();
+	if (ActiveMode && ActiveMode->OnEnter)
 	{
-		bOrientRotationToMovement = true;
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(96.f);
-		const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
-		const FRotator CleanRotation = FRotator(0.f, DirtyRotation.Yaw, 0.f);
-		UpdatedComponent->SetRelativeRotation(CleanRotation);
-		StopMovementKeepPathing();
-		OnExitClimbState.ExecuteIfBound();
+		(this->*ActiveMode->OnEnter)();
 	}
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 }
 
+void USRS_MovementComponent::OnEnterClimbing()
+{
+	bOrientRotationToMovement = false;
+	ClimbDistanceTravelled = 0.f;
+	CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(48.f);
+	// Spline climbers follow their spline and keep no surface to space along
+	if (ClimberSpacing && !IsSplineClimbing())
+	{
+		ClimberSpacing->RegisterClimber(this);
+	}
+	MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::ClimbStarted);
+	OnEnterClimbState.ExecuteIfBound();
+}
+
+void USRS_MovementComponent::OnExitClimbing()
+{
+	ClearClimbAnchor();
+	if (ClimberSpacing)
+	{
+		ClimberSpacing->UnregisterClimber(this);
+	}
+	bOrientRotationToMovement = true;
+	CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(96.f);
+	const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
+	const FRotator CleanRotation = FRotator(0.f, DirtyRotation.Yaw, 0.f);
+	UpdatedComponent->SetRelativeRotation(CleanRotation);
+	StopMovementKeepPathing();
+	++ClimbTransitionSequence;
+	MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::ClimbStopped);
+	OnExitClimbState.ExecuteIfBound();
+}
+
+void USRS_MovementComponent::OnEnterSplineClimbing()
+{
+	OnEnterClimbing();
+}
+
+void USRS_MovementComponent::OnExitSplineClimbing()
+{
+	GetSplineClimbState() = FSRS_SplineClimbModeState();
+	OnExitClimbing();
+}
+
+void USRS_MovementComponent::OnEnterLedgeHang()
+{
+	OnEnterClimbing();
+}
+
+void USRS_MovementComponent::OnExitLedgeHang()
+{
+	GetLedgeHangState() = FSRS_LedgeHangModeState();
+	OnExitClimbing();
+}
+
 void USRS_MovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
 {
-	if (IsClimbing())
+	if (const FSRS_CustomMovementModeEntry* ActiveMode = GetActiveCustomMovementMode())
 	{
-		PhysClimbing(DeltaTime, Iterations);		
+		(this->*ActiveMode->Phys)(DeltaTime, Iterations);
 	}
 	Super::PhysCustom(DeltaTime, Iterations);
 }
 
 float USRS_MovementComponent::GetMaxSpeed() const
 {
-	if (IsClimbing())
+	if (const FSRS_CustomMovementModeEntry* ActiveMode = GetActiveCustomMovementMode())
 	{
-		return MaxClimbSpeed;
+		return ActiveMode->MaxSpeed;
 	}
 	return Super::GetMaxSpeed();
 }
 
 float USRS_MovementComponent::GetMaxAcceleration() const
 {
-	if (IsClimbing())
+	if (const FSRS_CustomMovementModeEntry* ActiveMode = GetActiveCustomMovementMode())
 	{
-		return MaxClimbAcceleration;
+		return ActiveMode->MaxAcceleration;
 	}
 	return Super::GetMaxAcceleration();
 }
@@ -137,7 +652,7 @@ float USRS_MovementComponent::GetMaxAcceleration() const
 FVector USRS_MovementComponent::ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity,
 	const FVector& CurrentVelocity) const
 {
-	const bool bIsPlayingClimbMontage = IsFalling() && OwningPlayerAnimInstance && OwningPlayerAnimInstance->IsAnyMontagePlaying();
+	const bool bIsPlayingClimbMontage = IsFalling() && IsPlayingClimbMontage();
 	if (bIsPlayingClimbMontage)
 	{
 		return RootMotionVelocity;
@@ -146,6 +661,74 @@ FVector USRS_MovementComponent::ConstrainAnimRootMotionVelocity(const FVector& R
 	
 }
 
+void USRS_MovementComponent::PerformMovement(float DeltaTime)
+{
+	if (ActiveBakedTrack)
+	{
+		AccumulateBakedRootMotion(DeltaTime);
+	}
+	const bool bWasClimbing = IsClimbing();
+	const FVector OldLocation = UpdatedComponent ? UpdatedComponent->GetComponentLocation() : FVector::ZeroVector;
+	Super::PerformMovement(DeltaTime);
+	if (bWasClimbing && IsClimbing())
+	{
+		ClimbDistanceTravelled += FVector::VectorPlaneProject(UpdatedComponent->GetComponentLocation() - OldLocation, CurrentClimbableSurfaceNormal).Size();
+	}
+	if (ActiveBakedTrack && BakedTrackTime >= ActiveBakedTrack->Duration)
+	{
+		FinishBakedRootMotion();
+	}
+}
+
+bool USRS_MovementComponent::ShouldUseBakedRootMotion() const
+{
+	return BakedRootMotion && (IsNetMode(NM_DedicatedServer) || CVarForceBakedRootMotion.GetValueOnGameThread());
+}
+
+bool USRS_MovementComponent::IsPlayingClimbMontage() const
+{
+	return ActiveBakedTrack || (OwningPlayerAnimInstance && OwningPlayerAnimInstance->IsAnyMontagePlaying());
+}
+
+bool USRS_MovementComponent::IsClimbMontageActive() const
+{
+	// Unlike IsPlayingClimbMontage, a montage blending out no longer blocks the next one
+	return ActiveBakedTrack || (OwningPlayerAnimInstance && OwningPlayerAnimInstance->GetActiveMontageInstance());
+}
+
+void USRS_MovementComponent::AccumulateBakedRootMotion(float DeltaTime)
+{
+	const float StartTime = BakedTrackTime;
+	BakedTrackTime = FMath::Min(BakedTrackTime + DeltaTime, ActiveBakedTrack->Duration);
+	FTransform LocalRootMotion = ActiveBakedTrack->ExtractDelta(StartTime, BakedTrackTime);
+
+	// Spread the remaining error to the warp target over what is left of the window, in place of the motion warping modifiers
+	const FSRS_BakedWarpWindow* WarpWindow = ActiveBakedTrack->FindWarpWindow(StartTime);
+	const UMotionWarpingComponent* MotionWarpingComp = OwningClimbingCharacter ? OwningClimbingCharacter->GetMotionWarpingComponent() : nullptr;
+	const FMotionWarpingTarget* WarpTarget = WarpWindow && MotionWarpingComp ? MotionWarpingComp->FindWarpTarget(WarpWindow->WarpTargetName) : nullptr;
+	if (WarpTarget)
+	{
+		const USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+		const FQuat MeshRotation = Mesh->GetComponentQuat();
+		const FVector RootOffset = Mesh->GetComponentLocation() - UpdatedComponent->GetComponentLocation();
+		const FVector WorldDelta = MeshRotation.RotateVector(LocalRootMotion.GetTranslation());
+		const FVector RemainingDelta = MeshRotation.RotateVector(ActiveBakedTrack->ExtractDelta(BakedTrackTime, WarpWindow->EndTime).GetTranslation());
+		const FVector PredictedRoot = UpdatedComponent->GetComponentLocation() + RootOffset + WorldDelta + RemainingDelta;
+		const float RemainingTime = FMath::Max(WarpWindow->EndTime - StartTime, DeltaTime);
+		const FVector Correction = (WarpTarget->GetLocation() - PredictedRoot) * FMath::Min(DeltaTime / RemainingTime, 1.f);
+		LocalRootMotion.SetTranslation(MeshRotation.UnrotateVector(WorldDelta + Correction));
+	}
+
+	RootMotionParams.Set(LocalRootMotion);
+}
+
+void USRS_MovementComponent::FinishBakedRootMotion()
+{
+	ActiveBakedTrack = nullptr;
+	BakedTrackTime = 0.f;
+	CompleteClimbTransition(ActiveBakedMontage);
+}
+
 bool USRS_MovementComponent::TraceClimbableSurfaces()
 {
 	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.f;
@@ -177,13 +760,26 @@ void USRS_MovementComponent::ToggleClimbing(bool bEnableClimbing)
 {
 	if (bEnableClimbing)
 	{
-		if (CanClimb())
+		if (ASRS_ClimbableSplineActor* ClimbableSpline = ClimbableSplineCandidate.Get())
+		{
+			StartSplineClimbing(ClimbableSpline);
+			SendClimbRequest(ESRS_ClimbClaimType::Spline);
+		}
+		else if (CanClimb())
 		{
-			PlayClimbMontage(IdleToClimb);
+			// Claim the surface just traced rather than whatever was climbed last
+			ProcessClimbableSurface();
+			if (PlayClimbMontage(ESRS_ClimbMontage::IdleToClimb))
+			{
+				SendClimbRequest(ESRS_ClimbClaimType::Climb);
+			}
 		}
 		else if (CanClimbDown())
 		{
-			PlayClimbMontage(ClimbDownLedge);
+			if (PlayClimbMontage(ESRS_ClimbMontage::ClimbDownLedge))
+			{
+				SendClimbRequest(ESRS_ClimbClaimType::ClimbDown);
+			}
 		}
 		else
 		{
@@ -193,42 +789,77 @@ void USRS_MovementComponent::ToggleClimbing(bool bEnableClimbing)
 	if (!bEnableClimbing)
 	{
 		StopClimbing();
+		if (CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy)
+		{
+			ServerStopClimbing();
+		}
 	}
 }
 
-void USRS_MovementComponent::RequestHop()
+void USRS_MovementComponent::RequestHop(const FVector& InputDirection)
 {
-	const FVector HopDirection = UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(),GetLastInputVector());
-	const float HopDot = FVector::DotProduct(HopDirection.GetSafeNormal(), FVector::UpVector);
-	const float HopDotSide = FVector::DotProduct(HopDirection.GetSafeNormal(), UpdatedComponent->GetRightVector());
-	if (HopDot >= 0.9f)
+	if (IsSplineClimbing()) { return; }
+	const FVector HopDirection = UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), InputDirection);
+	const SRS::ClimbKernels::EHopDirection Direction = SRS::ClimbKernels::ClassifyHop(ToKernel(HopDirection), ToKernel(UpdatedComponent->GetRightVector()));
+	if (IsLedgeHanging())
 	{
-		HandleHopUp();
+		// Hopping off a ledge either mantles it or lets go
+		if (Direction == SRS::ClimbKernels::EHopDirection::Up)
+		{
+			MantleLedge();
+		}
+		else if (Direction == SRS::ClimbKernels::EHopDirection::Down)
+		{
+			StopClimbing();
+		}
+		return;
 	}
-	else if (HopDot <= -0.9f)
+	if (!IsClimbMoveAllowed(ESRS_ClimbMove::Hop)) { return; }
+	switch (Direction)
 	{
+	case SRS::ClimbKernels::EHopDirection::Up:
+		HandleHopUp();
+		break;
+	case SRS::ClimbKernels::EHopDirection::Down:
 		HandleHopDown();
-	}
-	else if (HopDotSide >= 0.9f)
-	{
+		break;
+	case SRS::ClimbKernels::EHopDirection::Right:
 		// Right
-	}
-	else if (HopDotSide <= -0.9f)
-	{
+		break;
+	case SRS::ClimbKernels::EHopDirection::Left:
 		// Left
+		break;
+	default:
+		break;
 	}
 }
 
 bool USRS_MovementComponent::IsClimbing() const
 {
-	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Climb;
+	return MovementMode == MOVE_Custom && (CustomMovementMode == ECustomMovementMode::MOVE_Climb || CustomMovementMode == ECustomMovementMode::MOVE_SplineClimb
+		|| CustomMovementMode == ECustomMovementMode::MOVE_LedgeHang);
+}
+
+bool USRS_MovementComponent::IsSplineClimbing() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_SplineClimb;
+}
+
+bool USRS_MovementComponent::IsLedgeHanging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_LedgeHang;
 }
 
 bool USRS_MovementComponent::CanClimb()
 {
 	if (IsFalling()) { return false; }
 	if (!TraceClimbableSurfaces()) { return false; }
-	if (!TraceFromEyeHeight(100.f, 0.f).bBlockingHit) { return false; }
+	if (!IsClimbMoveAllowedOn(ClimbableSurfacesHits[0].GetComponent(), ESRS_ClimbMove::Climb)) { return false; }
+	if (!TraceFromEyeHeight(100.f, 0.f).bBlockingHit)
+	{
+		RecordHeatmapEvent(ESRS_ClimbHeatmapEvent::EyeTraceRejected);
+		return false;
+	}
 	return true;
 }
 
@@ -251,7 +882,7 @@ bool USRS_MovementComponent::CanClimbDown()
 	FHitResult LedgeHit = DoLineTraceSingleByObject(LedgeStart, LedgeEnd);
 	if (Hit.bBlockingHit && !LedgeHit.bBlockingHit)
 	{
-		return true;
+		return IsClimbMoveAllowedOn(Hit.GetComponent(), ESRS_ClimbMove::ClimbDown);
 	}
 	return false;
 }
@@ -268,10 +899,23 @@ void USRS_MovementComponent::PhysClimbing(float DeltaTime, int32 Iterations)
 		return;
 	}
 
-	TraceClimbableSurfaces();
-	ProcessClimbableSurface();
-
-	if (ShouldStopClimbing() || CheckHasReachedGround())
+	ApplyClimbBaseMovement();
+	if (IsClimbAnchorStale())
+	{
+		TraceClimbableSurfaces();
+		ProcessClimbableSurface();
+		RecordClimbAnchor();
+	}
+	else
+	{
+		ResolveClimbAnchor();
+	}
+	const bool bShouldStopClimbing = ShouldStopClimbing();
+	if (bShouldStopClimbing)
+	{
+		RecordHeatmapEvent(ESRS_ClimbHeatmapEvent::ClimbDropped);
+	}
+	if (bShouldStopClimbing || CheckHasReachedGround())
 	{
 		StopClimbing();
 		return;
@@ -282,56 +926,432 @@ void USRS_MovementComponent::PhysClimbing(float DeltaTime, int32 Iterations)
 	if( !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() )
 	{
 		CalcVelocity(DeltaTime, 0.f, true, MaxBreakClimbDeceleration);
+		ApplyClimberSeparation();
 	}
 
 	ApplyRootMotionToVelocity(DeltaTime);
 
+	const bool bFusedMove = CVarClimbFusedMove.GetValueOnGameThread();
 	FVector OldLocation = UpdatedComponent->GetComponentLocation();
-	const FVector Adjusted = Velocity * DeltaTime;
+	const FVector Adjusted = Velocity * DeltaTime + (bFusedMove ? GetClimbSnapDelta(DeltaTime) : FVector::ZeroVector);
 	FHitResult Hit(1.f);
 	SafeMoveUpdatedComponent(Adjusted, GetClimbRotation(DeltaTime), true, Hit);
+	++ClimbSweepTicks;
+	++ClimbSweeps;
 
 	if (Hit.Time < 1.f)
 	{
 		HandleImpact(Hit, DeltaTime, Adjusted);
 		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+		++ClimbSweeps;
 	}
 
 	if(!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity() )
 	{
 		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+		if (bFusedMove)
+		{
+			// The snap runs along the surface normal, keep it out of the climb velocity as the separate move did
+			Velocity = FVector::VectorPlaneProject(Velocity, CurrentClimbableSurfaceNormal);
+		}
+	}
+	if (!bFusedMove)
+	{
+		SnapToClimbableSurface(DeltaTime);
 	}
-	SnapToClimbableSurface(DeltaTime);
 	if (HasReachLedge())
 	{
-		PlayClimbMontage(ClimbUpLedge);
+		MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::LedgeReached);
+		if (!bEnableLedgeHang || !StartLedgeHang())
+		{
+			PlayClimbMontage(ESRS_ClimbMontage::ClimbUpLedge);
+		}
+	}
+}
+
+void USRS_MovementComponent::PhysSplineClimbing(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+	FSRS_SplineClimbModeState& SplineState = GetSplineClimbState();
+	ASRS_ClimbableSplineActor* Spline = SplineState.Spline.Get();
+	if (!Spline)
+	{
+		StopClimbing();
+		return;
+	}
+
+	// Input along the climber's up axis moves it along the spline, the geometry is known so nothing is traced
+	const float MaxAccel = GetMaxAcceleration();
+	const float ClimbInput = MaxAccel > 0.f ? FMath::Clamp(FVector::DotProduct(Acceleration, UpdatedComponent->GetUpVector()) / MaxAccel, -1.f, 1.f) : 0.f;
+	const float SplineLength = Spline->GetSplineLength();
+	const float NewDistance = SplineState.Distance + ClimbInput * GetMaxSpeed() * DeltaTime;
+	if (NewDistance >= SplineLength && ClimbInput > 0.f && ExitSplineClimbing(true))
+	{
+		return;
+	}
+	if (NewDistance <= 0.f && ClimbInput < 0.f && ExitSplineClimbing(false))
+	{
+		return;
+	}
+	SplineState.Distance = FMath::Clamp(NewDistance, 0.f, SplineLength);
+
+	const FTransform ClimbTransform = Spline->GetClimbTransform(SplineState.Distance);
+	// Keep the surface in step with the spline, climb input is built on it
+	CurrentClimbableSurfaceNormal = -ClimbTransform.GetRotation().GetForwardVector();
+	CurrentClimbableSurfaceLocation = ClimbTransform.GetLocation() - CurrentClimbableSurfaceNormal * Spline->GetClimbOffset();
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat NewRotation = FMath::QInterpTo(UpdatedComponent->GetComponentQuat(), ClimbTransform.GetRotation(), DeltaTime, 10.f);
+	MoveUpdatedComponent(ClimbTransform.GetLocation() - OldLocation, NewRotation, false);
+	Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+}
+
+void USRS_MovementComponent::StartSplineClimbing(ASRS_ClimbableSplineActor* Spline)
+{
+	if (!Spline) { return; }
+	FSRS_SplineClimbModeState& SplineState = GetSplineClimbState();
+	SplineState.Spline = Spline;
+
+	// Enter at the nearer authored end. From the top start a body height down so holding up does not leave straight away.
+	const float SplineLength = Spline->GetSplineLength();
+	const float ClosestDistance = Spline->FindClosestDistance(UpdatedComponent->GetComponentLocation());
+	const float TopEntryDistance = SplineLength - CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() * 2.f;
+	SplineState.Distance = ClosestDistance > SplineLength * 0.5f ? FMath::Max(TopEntryDistance, 0.f) : 0.f;
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_SplineClimb);
+}
+
+bool USRS_MovementComponent::ExitSplineClimbing(bool bOverTop)
+{
+	const ASRS_ClimbableSplineActor* Spline = GetSplineClimbState().Spline.Get();
+	if (!Spline) { return false; }
+	const FVector ExitLocation = bOverTop ? Spline->GetTopExitLocation() : Spline->GetBottomExitLocation();
+
+	// The capsule is still at climbing size, test the standing one it gets back on leaving the mode
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const FCollisionShape StandingShape = FCollisionShape::MakeCapsule(Capsule->GetScaledCapsuleRadius(), 96.f * Capsule->GetShapeScale());
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbSplineExit), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	InitCollisionParams(QueryParams, ResponseParams);
+	if (GetWorld()->OverlapBlockingTestByChannel(ExitLocation, FQuat::Identity, UpdatedComponent->GetCollisionObjectType(), StandingShape, QueryParams, ResponseParams))
+	{
+		return false;
+	}
+
+	const FRotator ExitRotation(0.f, UpdatedComponent->GetComponentRotation().Yaw, 0.f);
+	SetMovementMode(MOVE_Falling);
+	CharacterOwner->TeleportTo(ExitLocation, ExitRotation);
+	// Replayed moves after a correction exit again, the server only needs to hear about the first
+	if (CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy && !CharacterOwner->bClientUpdating)
+	{
+		ServerExitSplineClimbing(bOverTop);
+	}
+	return true;
+}
+
+void USRS_MovementComponent::PhysLedgeHang(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+	FSRS_LedgeHangModeState& Ledge = GetLedgeHangState();
+	if (Ledge.Points.IsEmpty())
+	{
+		StopClimbing();
+		return;
+	}
+
+	// The mantle montage carries the climber off the ledge by root motion
+	if (HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity())
+	{
+		RestorePreAdditiveRootMotionVelocity();
+		ApplyRootMotionToVelocity(DeltaTime);
+		FHitResult Hit(1.f);
+		SafeMoveUpdatedComponent(Velocity * DeltaTime, GetClimbRotation(DeltaTime), true, Hit);
+		return;
+	}
+
+	FVector EdgeLocation, EdgeNormal, EdgeTangent;
+	EvaluateLedge(Ledge.Distance, EdgeLocation, EdgeNormal, EdgeTangent);
+	const float MaxAccel = GetMaxAcceleration();
+	const float ShimmyInput = MaxAccel > 0.f ? FMath::Clamp(FVector::DotProduct(Acceleration, EdgeTangent) / MaxAccel, -1.f, 1.f) : 0.f;
+	const float ClimbInput = MaxAccel > 0.f ? FMath::Clamp(FVector::DotProduct(Acceleration, FVector::UpVector) / MaxAccel, -1.f, 1.f) : 0.f;
+	if (ClimbInput > 0.5f && MantleLedge())
+	{
+		// The mantle montage moves the climber from the next tick on
+		return;
+	}
+	if (ClimbInput < -0.5f)
+	{
+		// Lower back onto the wall, climbing sweeps for it again and drops if there is none
+		StartClimbing();
+		return;
+	}
+
+	// Only the cached edge is followed, it is probed further only when the climber nears an open end
+	Ledge.Distance += ShimmyInput * GetMaxSpeed() * DeltaTime;
+	if (ShimmyInput > 0.f && Ledge.Distance > Ledge.Length - LedgeProbeSpacing)
+	{
+		ExtendLedge(true);
+	}
+	else if (ShimmyInput < 0.f && Ledge.Distance < LedgeProbeSpacing)
+	{
+		ExtendLedge(false);
+	}
+	Ledge.Distance = FMath::Clamp(Ledge.Distance, 0.f, Ledge.Length);
+
+	EvaluateLedge(Ledge.Distance, EdgeLocation, EdgeNormal, EdgeTangent);
+	// Keep the surface in step with the ledge, climb input is built on it
+	CurrentClimbableSurfaceNormal = EdgeNormal;
+	CurrentClimbableSurfaceLocation = EdgeLocation;
+	const FVector HangLocation = EdgeLocation + EdgeNormal * LedgeHangWallOffset - FVector::UpVector * LedgeHangDropHeight;
+	const FQuat HangRotation = FRotationMatrix::MakeFromXZ(-EdgeNormal, FVector::UpVector).ToQuat();
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat NewRotation = FMath::QInterpTo(UpdatedComponent->GetComponentQuat(), HangRotation, DeltaTime, 10.f);
+	MoveUpdatedComponent(HangLocation - OldLocation, NewRotation, false);
+	Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+}
+
+bool USRS_MovementComponent::StartLedgeHang()
+{
+	if (IsClimbMontageActive()) { return false; }
+	if (!IsClimbMoveAllowed(ESRS_ClimbMove::LedgeHang)) { return false; }
+	const FVector WallNormal = FVector::VectorPlaneProject(CurrentClimbableSurfaceNormal, FVector::UpVector).GetSafeNormal();
+	if (WallNormal.IsNearlyZero()) { return false; }
+
+	// HasReachLedge found the top below the raised eye trace, probe down from there at the wall
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector WallLocation = ComponentLocation - WallNormal * FVector::PointPlaneDist(ComponentLocation, CurrentClimbableSurfaceLocation, WallNormal);
+	const FVector Reference = WallLocation + FVector::UpVector * (CharacterOwner->BaseEyeHeight + 50.f);
+	FSRS_LedgePoint GrabPoint;
+	if (!ProbeLedgePoint(Reference, WallNormal, GrabPoint)) { return false; }
+
+	FSRS_LedgeHangModeState& Ledge = GetLedgeHangState();
+	Ledge = FSRS_LedgeHangModeState();
+	Ledge.Points.Add(GrabPoint);
+	for (int32 Index = 0; Index < LedgeInitialProbes; ++Index)
+	{
+		ExtendLedge(true);
+		ExtendLedge(false);
+	}
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_LedgeHang);
+	return true;
+}
+
+bool USRS_MovementComponent::MantleLedge()
+{
+	if (!IsLedgeHanging()) { return false; }
+	return PlayClimbMontage(ESRS_ClimbMontage::ClimbUpLedge);
+}
+
+bool USRS_MovementComponent::ProbeLedgePoint(const FVector& Reference, const FVector& WallNormal, FSRS_LedgePoint& OutPoint)
+{
+	// Down onto the top just behind the edge, which has to be walkable
+	const FVector TopStart = Reference - WallNormal * 15.f + FVector::UpVector * 60.f;
+	const FHitResult TopHit = DoLineTraceSingleByObject(TopStart, TopStart - FVector::UpVector * 160.f);
+	if (!TopHit.bBlockingHit || TopHit.bStartPenetrating) { return false; }
+	if (FVector::DotProduct(TopHit.ImpactNormal, FVector::UpVector) < 0.5f) { return false; }
+
+	// Back into the wall face just under the top
+	const FVector FaceStart = TopHit.ImpactPoint + WallNormal * 55.f - FVector::UpVector * 10.f;
+	const FHitResult FaceHit = DoLineTraceSingleByObject(FaceStart, FaceStart - WallNormal * 80.f);
+	if (!FaceHit.bBlockingHit) { return false; }
+	OutPoint.Normal = FVector::VectorPlaneProject(FaceHit.ImpactNormal, FVector::UpVector).GetSafeNormal();
+	if (OutPoint.Normal.IsNearlyZero()) { return false; }
+	OutPoint.Location = FaceHit.ImpactPoint + FVector::UpVector * FVector::DotProduct(TopHit.ImpactPoint - FaceHit.ImpactPoint, FVector::UpVector);
+	return true;
+}
+
+bool USRS_MovementComponent::ExtendLedge(bool bAtEnd)
+{
+	FSRS_LedgeHangModeState& Ledge = GetLedgeHangState();
+	bool& bClosed = bAtEnd ? Ledge.bEndClosed : Ledge.bStartClosed;
+	if (bClosed || Ledge.Points.IsEmpty()) { return false; }
+
+	const FSRS_LedgePoint Tip = bAtEnd ? Ledge.Points.Last() : Ledge.Points[0];
+	const FVector Direction = Ledge.Points.Num() > 1
+		? (Tip.Location - (bAtEnd ? Ledge.Points.Last(1) : Ledge.Points[1]).Location).GetSafeNormal()
+		: FVector::CrossProduct(FVector::UpVector, -Tip.Normal) * (bAtEnd ? 1.f : -1.f);
+	FSRS_LedgePoint Point;
+	const bool bFound = ProbeLedgePoint(Tip.Location + Direction * LedgeProbeSpacing, Tip.Normal, Point);
+	const float SegmentLength = bFound ? FVector::Dist(Tip.Location, Point.Location) : 0.f;
+	// A probe that lands far from the tip found some other ledge, not the continuation of this one
+	if (!bFound || SegmentLength < KINDA_SMALL_NUMBER || SegmentLength > LedgeProbeSpacing * 2.f)
+	{
+		bClosed = true;
+		return false;
+	}
+
+	if (bAtEnd)
+	{
+		Ledge.Points.Add(Point);
+	}
+	else
+	{
+		Ledge.Points.Insert(Point, 0);
+		Ledge.Distance += SegmentLength;
+	}
+	Ledge.Length += SegmentLength;
+
+	if (Ledge.Points.Num() > MaxLedgePoints)
+	{
+		// Forget the point furthest behind, its end can be probed again if the climber turns back
+		if (bAtEnd)
+		{
+			const float DroppedLength = FVector::Dist(Ledge.Points[0].Location, Ledge.Points[1].Location);
+			Ledge.Points.RemoveAt(0);
+			Ledge.Distance -= DroppedLength;
+			Ledge.Length -= DroppedLength;
+			Ledge.bStartClosed = false;
+		}
+		else
+		{
+			Ledge.Length -= FVector::Dist(Ledge.Points.Last().Location, Ledge.Points.Last(1).Location);
+			Ledge.Points.Pop();
+			Ledge.bEndClosed = false;
+		}
+	}
+	return true;
+}
+
+void USRS_MovementComponent::EvaluateLedge(float Distance, FVector& OutLocation, FVector& OutNormal, FVector& OutTangent) const
+{
+	const FSRS_LedgeHangModeState& Ledge = GetLedgeHangState();
+	const FSRS_LedgePoint& First = Ledge.Points[0];
+	OutLocation = First.Location;
+	OutNormal = First.Normal;
+	OutTangent = FVector::CrossProduct(FVector::UpVector, -First.Normal);
+	float Remaining = Distance;
+	for (int32 Index = 1; Index < Ledge.Points.Num(); ++Index)
+	{
+		const FSRS_LedgePoint& Start = Ledge.Points[Index - 1];
+		const FSRS_LedgePoint& End = Ledge.Points[Index];
+		const float SegmentLength = FVector::Dist(Start.Location, End.Location);
+		if (Remaining <= SegmentLength || Index == Ledge.Points.Num() - 1)
+		{
+			const float Alpha = SegmentLength > KINDA_SMALL_NUMBER ? FMath::Clamp(Remaining / SegmentLength, 0.f, 1.f) : 0.f;
+			OutLocation = FMath::Lerp(Start.Location, End.Location, Alpha);
+			OutNormal = FMath::Lerp(Start.Normal, End.Normal, Alpha).GetSafeNormal();
+			OutTangent = (End.Location - Start.Location).GetSafeNormal();
+			return;
+		}
+		Remaining -= SegmentLength;
+	}
+}
+
+void USRS_MovementComponent::SetClimbableSplineCandidate(ASRS_ClimbableSplineActor* Spline)
+{
+	ClimbableSplineCandidate = Spline;
+}
+
+void USRS_MovementComponent::ClearClimbableSplineCandidate(ASRS_ClimbableSplineActor* Spline)
+{
+	if (ClimbableSplineCandidate.Get() == Spline)
+	{
+		ClimbableSplineCandidate.Reset();
 	}
 }
 
 void USRS_MovementComponent::ProcessClimbableSurface()
 {
-	CurrentClimbableSurfaceLocation = FVector::ZeroVector;
-	CurrentClimbableSurfaceNormal = FVector::ZeroVector;
+	SRS::ClimbKernels::FSurfaceAccumulator Surface;
+	for (const FHitResult& Hit : ClimbableSurfacesHits)
+	{
+		Surface.Add(ToKernel(Hit.ImpactPoint), ToKernel(Hit.ImpactNormal));
+	}
+	CurrentClimbableSurfaceLocation = FromKernel(Surface.GetLocation());
+	CurrentClimbableSurfaceNormal = FromKernel(Surface.GetNormal());
+
+	const uint8 ClassId = ClimbableSurfacesHits.IsEmpty() ? CurrentClimbabilityClassId : GetClimbabilityClassId(ClimbableSurfacesHits[0].GetComponent());
+	if (ClassId != CurrentClimbabilityClassId)
+	{
+		ApplyClimbabilityClass(ClassId);
+	}
+}
+
+void USRS_MovementComponent::ApplyClimbBaseMovement()
+{
+	if (!bHasClimbAnchor) { return; }
+	const UPrimitiveComponent* ClimbBase = ClimbBaseComponent.Get();
+	if (!ClimbBase)
+	{
+		ClearClimbAnchor();
+		return;
+	}
+	const FTransform& NewBaseTransform = ClimbBase->GetComponentTransform();
+	if (NewBaseTransform.Equals(ClimbBaseTransform)) { return; }
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector LocalLocation = ClimbBaseTransform.InverseTransformPositionNoScale(OldLocation);
+	const FVector NewLocation = NewBaseTransform.TransformPositionNoScale(LocalLocation);
+	const FQuat DeltaRotation = NewBaseTransform.GetRotation() * ClimbBaseTransform.GetRotation().Inverse();
+	const FQuat NewRotation = DeltaRotation * UpdatedComponent->GetComponentQuat();
+	ClimbBaseTransform = NewBaseTransform;
+	// Swept so a base moving the climber into other geometry cannot push it through
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(NewLocation - OldLocation, NewRotation, true, Hit, ETeleportType::TeleportPhysics);
+}
 
+bool USRS_MovementComponent::IsClimbAnchorStale() const
+{
+	if (!bHasClimbAnchor || !ClimbBaseComponent.IsValid()) { return true; }
+	const FVector LocalPawnLocation = ClimbBaseTransform.InverseTransformPositionNoScale(UpdatedComponent->GetComponentLocation());
+	const FVector LocalDelta = LocalPawnLocation - ClimbAnchorLocalPawnLocation;
+	// The recorded hits only hold near where they were taken, moving along the wall can take the climber past an edge
+	if (FVector::VectorPlaneProject(LocalDelta, ClimbAnchorLocalNormal).SizeSquared() > FMath::Square(ClimbAnchorLateralStaleDistance)) { return true; }
+	return FMath::Abs(FVector::DotProduct(LocalDelta, ClimbAnchorLocalNormal)) > ClimbAnchorStaleDistance;
+}
+
+void USRS_MovementComponent::RecordClimbAnchor()
+{
+	ClearClimbAnchor();
 	if (ClimbableSurfacesHits.IsEmpty()) { return; }
 
+	// Averaged surfaces spanning several primitives have no single frame to live in, keep sweeping them
+	UPrimitiveComponent* ClimbBase = ClimbableSurfacesHits[0].GetComponent();
+	if (!ClimbBase) { return; }
 	for (const FHitResult& Hit : ClimbableSurfacesHits)
 	{
-		CurrentClimbableSurfaceLocation += Hit.ImpactPoint;
-		CurrentClimbableSurfaceNormal += Hit.ImpactNormal;
+		if (Hit.GetComponent() != ClimbBase) { return; }
 	}
 
-	CurrentClimbableSurfaceLocation /= ClimbableSurfacesHits.Num();
-	CurrentClimbableSurfaceNormal = CurrentClimbableSurfaceNormal.GetSafeNormal();
+	ClimbBaseComponent = ClimbBase;
+	ClimbBaseTransform = ClimbBase->GetComponentTransform();
+	ClimbAnchorLocalLocation = ClimbBaseTransform.InverseTransformPositionNoScale(CurrentClimbableSurfaceLocation);
+	ClimbAnchorLocalNormal = ClimbBaseTransform.InverseTransformVectorNoScale(CurrentClimbableSurfaceNormal);
+	ClimbAnchorLocalPawnLocation = ClimbBaseTransform.InverseTransformPositionNoScale(UpdatedComponent->GetComponentLocation());
+	bHasClimbAnchor = true;
+}
+
+void USRS_MovementComponent::ResolveClimbAnchor()
+{
+	CurrentClimbableSurfaceLocation = ClimbBaseTransform.TransformPositionNoScale(ClimbAnchorLocalLocation);
+	CurrentClimbableSurfaceNormal = ClimbBaseTransform.TransformVectorNoScale(ClimbAnchorLocalNormal).GetSafeNormal();
+}
+
+void USRS_MovementComponent::ClearClimbAnchor()
+{
+	ClimbBaseComponent = nullptr;
+	bHasClimbAnchor = false;
+}
+
+void USRS_MovementComponent::ApplyClimberSeparation()
+{
+	if (!ClimberSpacing || ClimberSeparationSpeed <= 0.f) { return; }
+	const FVector Anchor = USRS_ClimberSpacingSubsystem::ProjectAnchor(UpdatedComponent->GetComponentLocation(), CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal);
+	const FVector Separation = ClimberSpacing->ComputeSeparation(this, Anchor, CurrentClimbableSurfaceNormal);
+	if (Separation.IsNearlyZero()) { return; }
+	Velocity = (Velocity + Separation * ClimberSeparationSpeed).GetClampedToMaxSize(GetMaxSpeed());
 }
 
 bool USRS_MovementComponent::ShouldStopClimbing()
 {
 	if (ClimbableSurfacesHits.IsEmpty()) { return true; }
+	if (!IsClimbMoveAllowed(ESRS_ClimbMove::Climb)) { return true; }
 
-	const float DotResult = FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector);
-	const float DegreeDiff = FMath::RadiansToDegrees(FMath::Acos(DotResult));
-	return DegreeDiff <= 60.f;
+	return SRS::ClimbKernels::IsSurfaceTooFlat(ToKernel(CurrentClimbableSurfaceNormal), ToKernel(FVector::UpVector), CurrentCosMaxFloorAngle);
 }
 
 bool USRS_MovementComponent::CheckHasReachedGround()
@@ -354,40 +1374,52 @@ bool USRS_MovementComponent::CheckHasReachedGround()
 void USRS_MovementComponent::TryStartVaulting()
 {
 	FVector VaultStart, VaultEnd;
-	if (CanVault(VaultStart, VaultEnd))
+	if (CanVault(VaultStart, VaultEnd) && IsClimbMontageReady(ESRS_ClimbMontage::Vault))
 	{
 		SetMotionWarpTarget(FName("VaultStart"), VaultStart);
 		SetMotionWarpTarget(FName("VaultEnd"), VaultEnd);
 		StartClimbing();
-		PlayClimbMontage(Vault);
+		PlayClimbMontage(ESRS_ClimbMontage::Vault);
+		SendClimbRequest(ESRS_ClimbClaimType::Vault, VaultStart, VaultEnd);
+		MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::VaultAccepted);
+	}
+	else
+	{
+		MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::VaultRejected);
+		RecordHeatmapEvent(ESRS_ClimbHeatmapEvent::VaultRejected);
 	}
 }
 
 bool USRS_MovementComponent::CanVault(FVector& VaultStart, FVector& ValutEnd)
 {
 	if (IsFalling()) { return false; }
-	VaultStart = FVector::ZeroVector;
-	ValutEnd = FVector::ZeroVector;
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector ComponentUp = UpdatedComponent->GetUpVector();
-	const FVector ComponentDown = -UpdatedComponent->GetUpVector();
+	using namespace SRS::ClimbKernels;
+	const FVec3 ComponentLocation = ToKernel(UpdatedComponent->GetComponentLocation());
+	const FVec3 ComponentForward = ToKernel(UpdatedComponent->GetForwardVector());
+	const FVec3 ComponentUp = ToKernel(UpdatedComponent->GetUpVector());
 
-	for (int32 i = 0; i < 5; i++)
+	// SelectVaultPoints only reads the first and last probes, so the middle three are not traced
+	FVaultProbeResult Probes[VaultProbeCount];
+	UPrimitiveComponent* VaultComponent = nullptr;
+	for (const int32 i : { 0, VaultProbeCount - 1 })
 	{
-		const FVector Start = ComponentLocation + ComponentUp * 100.f + ComponentForward * 100.f * (i + 1);
-		const FVector End = Start + ComponentDown * 100.f * (i + 1);
-		FHitResult Hit = DoLineTraceSingleByObject(Start, End);
-		if (i == 0 && Hit.bBlockingHit)
-		{
-			VaultStart = Hit.ImpactPoint;
-		}
-		if (i == 4 && Hit.bBlockingHit)
+		FVec3 Start, End;
+		GetVaultProbe(i, ComponentLocation, ComponentForward, ComponentUp, Start, End);
+		const FHitResult Hit = DoLineTraceSingleByObject(FromKernel(Start), FromKernel(End));
+		Probes[i].bBlockingHit = Hit.bBlockingHit;
+		Probes[i].ImpactPoint = ToKernel(Hit.ImpactPoint);
+		if (i == 0)
 		{
-			ValutEnd = Hit.ImpactPoint;
+			VaultComponent = Hit.GetComponent();
 		}
 	}
-	return !VaultStart.IsZero() && !ValutEnd.IsZero();
+	if (Probes[0].bBlockingHit && !IsClimbMoveAllowedOn(VaultComponent, ESRS_ClimbMove::Vault)) { return false; }
+
+	FVec3 Start, End;
+	const bool bCanVault = SelectVaultPoints(Probes, VaultProbeCount, Start, End);
+	VaultStart = FromKernel(Start);
+	ValutEnd = FromKernel(End);
+	return bCanVault;
 }
 
 FQuat USRS_MovementComponent::GetClimbRotation(float DeltaTime)
@@ -403,17 +1435,29 @@ FQuat USRS_MovementComponent::GetClimbRotation(float DeltaTime)
 
 void USRS_MovementComponent::SnapToClimbableSurface(float DeltaTime)
 {
-	const FVector CompomentForward = UpdatedComponent->GetForwardVector();
-	const FVector CompomentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector ProjectedVector = (CurrentClimbableSurfaceLocation - CompomentLocation).ProjectOnTo(CompomentForward);
-	const FVector SnapLocation = -CurrentClimbableSurfaceNormal * ProjectedVector.Length();
-
 	UpdatedComponent->MoveComponent
 	(
-		SnapLocation * DeltaTime * MaxClimbSpeed,
+		GetClimbSnapDelta(DeltaTime),
 		UpdatedComponent->GetComponentQuat(),
 		true
 	);
+	++ClimbSweeps;
+}
+
+FVector USRS_MovementComponent::GetClimbSnapDelta(float DeltaTime) const
+{
+	const FVector SnapLocation = FromKernel(SRS::ClimbKernels::ComputeSnapVector
+	(
+		ToKernel(CurrentClimbableSurfaceLocation),
+		ToKernel(UpdatedComponent->GetComponentLocation()),
+		ToKernel(UpdatedComponent->GetForwardVector()),
+		ToKernel(CurrentClimbableSurfaceNormal)
+	));
+	// Close at most the gap left between the capsule and the climbed plane, pushing into the wall only blocks the sweep
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const float CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	const float Gap = FVector::PointPlaneDist(ComponentLocation, CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal) - CapsuleRadius - ClimbSnapSkin;
+	return (SnapLocation * DeltaTime * MaxClimbSpeed).GetClampedToMaxSize(FMath::Max(Gap, 0.f));
 }
 
 bool USRS_MovementComponent::HasReachLedge()
@@ -433,24 +1477,191 @@ bool USRS_MovementComponent::HasReachLedge()
 	return false;
 }
 
-void USRS_MovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+bool USRS_MovementComponent::PlayClimbMontage(ESRS_ClimbMontage Montage)
 {
-	if (!MontageToPlay) { return; }
-	if (!OwningPlayerAnimInstance) { return; }
-	if (OwningPlayerAnimInstance->IsAnyMontagePlaying()) { return; }
+	if (!ClimbMontages) { return false; }
+	if (IsClimbMontageActive()) { return false; }
+	if (ShouldUseBakedRootMotion())
+	{
+		if (const FSRS_BakedRootMotionTrack* Track = BakedRootMotion->FindTrack(ClimbMontages->GetSoftMontage(Montage).ToSoftObjectPath()))
+		{
+			ActiveBakedTrack = Track;
+			ActiveBakedMontage = Montage;
+			BakedTrackTime = 0.f;
+			return true;
+		}
+	}
+	UAnimMontage* MontageToPlay = ClimbMontages->GetLoadedMontage(Montage);
+	if (!MontageToPlay)
+	{
+		// Still streaming: grabbing a wall can happen without its animation, every other transition waits for the next attempt
+		RequestClimbMontagePreload();
+		if (Montage == ESRS_ClimbMontage::IdleToClimb)
+		{
+			CompleteClimbTransition(Montage);
+			return true;
+		}
+		return false;
+	}
+	if (!OwningPlayerAnimInstance) { return false; }
+	AbortedClimbMontage.Reset();
 	OwningPlayerAnimInstance->Montage_Play(MontageToPlay);
+	return true;
 }
 
-void USRS_MovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+bool USRS_MovementComponent::IsClimbMontageReady(ESRS_ClimbMontage Montage) const
 {
-	if (Montage == IdleToClimb || Montage == ClimbDownLedge)
+	if (!ClimbMontages) { return false; }
+	if (ShouldUseBakedRootMotion() && BakedRootMotion->FindTrack(ClimbMontages->GetSoftMontage(Montage).ToSoftObjectPath())) { return true; }
+	return ClimbMontages->GetLoadedMontage(Montage) != nullptr;
+}
+
+void USRS_MovementComponent::CompleteClimbTransition(ESRS_ClimbMontage Montage)
+{
+	switch (Montage)
 	{
+	case ESRS_ClimbMontage::IdleToClimb:
+	case ESRS_ClimbMontage::ClimbDownLedge:
 		StartClimbing();
 		StopMovementImmediately();
+		break;
+	case ESRS_ClimbMontage::ClimbUpLedge:
+	case ESRS_ClimbMontage::Vault:
+		SetMovementMode(MOVE_Walking);
+		break;
+	default:
+		break;
 	}
-	if (Montage == ClimbUpLedge || Montage == Vault)
+}
+
+void USRS_MovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+{
+	if (!IsClimbMontageActive())
 	{
-		SetMovementMode(MOVE_Walking);
+		bClimbInputWindowOpen = false;
+		bClimbCancelWindowOpen = false;
+	}
+	if (Montage && Montage == AbortedClimbMontage.Get()) { return; }
+	ESRS_ClimbMontage ClimbMontage;
+	if (ClimbMontages && ClimbMontages->FindMontage(Montage, ClimbMontage))
+	{
+		CompleteClimbTransition(ClimbMontage);
+	}
+}
+
+void USRS_MovementComponent::SendClimbRequest(ESRS_ClimbClaimType Type, const FVector& VaultStart, const FVector& VaultEnd)
+{
+	if (CharacterOwner->GetLocalRole() != ROLE_AutonomousProxy) { return; }
+	FSRS_ClimbRequest Request;
+	Request.Type = Type;
+	Request.Location = UpdatedComponent->GetComponentLocation();
+	Request.Forward = UpdatedComponent->GetForwardVector();
+	Request.SurfaceLocation = CurrentClimbableSurfaceLocation;
+	Request.SurfaceNormal = CurrentClimbableSurfaceNormal;
+	Request.VaultStart = VaultStart;
+	Request.VaultEnd = VaultEnd;
+	Request.Spline = Type == ESRS_ClimbClaimType::Spline ? GetSplineClimbState().Spline.Get() : nullptr;
+	ServerRequestClimbTransition(Request);
+}
+
+void USRS_MovementComponent::ServerRequestClimbTransition_Implementation(const FSRS_ClimbRequest& Request)
+{
+	++ClimbTransitionSequence;
+	if (ClimbValidation)
+	{
+		FSRS_ClimbClaim Claim;
+		Claim.Climber = this;
+		Claim.Player = CharacterOwner->GetPlayerState();
+		Claim.Type = Request.Type;
+		Claim.Location = Request.Location;
+		Claim.Forward = Request.Forward;
+		Claim.Up = UpdatedComponent->GetUpVector();
+		Claim.SurfaceLocation = Request.SurfaceLocation;
+		Claim.SurfaceNormal = Request.SurfaceNormal;
+		Claim.VaultStart = Request.VaultStart;
+		Claim.VaultEnd = Request.VaultEnd;
+		Claim.Spline = Request.Spline;
+		Claim.EyeHeight = CharacterOwner->BaseEyeHeight;
+		Claim.ServerLocation = UpdatedComponent->GetComponentLocation();
+		Claim.Time = GetWorld()->GetTimeSeconds();
+		Claim.TransitionSequence = ClimbTransitionSequence;
+		// A rejected claim has already been undone on the client
+		if (!ClimbValidation->SubmitClaim(Claim)) { return; }
+	}
+
+	// Repeat the transition so the server's moves agree with the client's
+	switch (Request.Type)
+	{
+	case ESRS_ClimbClaimType::Climb:
+		if (IsClimbing()) { return; }
+		CurrentClimbableSurfaceLocation = Request.SurfaceLocation;
+		CurrentClimbableSurfaceNormal = Request.SurfaceNormal;
+		PlayClimbMontage(ESRS_ClimbMontage::IdleToClimb);
+		break;
+	case ESRS_ClimbClaimType::ClimbDown:
+		if (IsClimbing()) { return; }
+		PlayClimbMontage(ESRS_ClimbMontage::ClimbDownLedge);
+		break;
+	case ESRS_ClimbClaimType::Vault:
+		if (!IsClimbMontageReady(ESRS_ClimbMontage::Vault)) { return; }
+		SetMotionWarpTarget(FName("VaultStart"), Request.VaultStart);
+		SetMotionWarpTarget(FName("VaultEnd"), Request.VaultEnd);
+		StartClimbing();
+		PlayClimbMontage(ESRS_ClimbMontage::Vault);
+		break;
+	case ESRS_ClimbClaimType::Spline:
+		if (IsClimbing() || !Request.Spline) { return; }
+		StartSplineClimbing(Request.Spline);
+		break;
+	}
+}
+
+void USRS_MovementComponent::ServerStopClimbing_Implementation()
+{
+	if (IsClimbing())
+	{
+		StopClimbing();
+	}
+}
+
+void USRS_MovementComponent::ServerExitSplineClimbing_Implementation(bool bOverTop)
+{
+	// The server's own moves may already have taken the climber off the spline
+	if (IsSplineClimbing())
+	{
+		ExitSplineClimbing(bOverTop);
+	}
+}
+
+void USRS_MovementComponent::RejectClimbTransition()
+{
+	AbortClimbTransition();
+	if (!CharacterOwner->IsLocallyControlled())
+	{
+		ClientRejectClimbTransition();
+	}
+}
+
+void USRS_MovementComponent::ClientRejectClimbTransition_Implementation()
+{
+	AbortClimbTransition();
+}
+
+void USRS_MovementComponent::AbortClimbTransition()
+{
+	if (ActiveBakedTrack)
+	{
+		ActiveBakedTrack = nullptr;
+		BakedTrackTime = 0.f;
+	}
+	if (OwningPlayerAnimInstance && OwningPlayerAnimInstance->GetActiveMontageInstance())
+	{
+		AbortedClimbMontage = OwningPlayerAnimInstance->GetCurrentActiveMontage();
+		CancelClimbMontage();
+	}
+	if (IsClimbing())
+	{
+		StopClimbing();
 	}
 }
 
@@ -466,7 +1677,8 @@ void USRS_MovementComponent::HandleHopUp()
 {
 	if (CanHopUp())
 	{
-		PlayClimbMontage(HopUp);
+		MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::HopUp);
+		PlayClimbMontage(ESRS_ClimbMontage::HopUp);
 	}
 }
 
@@ -485,7 +1697,8 @@ void USRS_MovementComponent::HandleHopDown()
 {
 	if (CanHopDown())
 	{
-		PlayClimbMontage(HopDown);
+		MarkTelemetryEvent(ESRS_ClimbTelemetryEvent::HopDown);
+		PlayClimbMontage(ESRS_ClimbMontage::HopDown);
 	}
 }
 
@@ -0,0 +1,264 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/SRS_ClimbHeatmapSubsystem.h"
+
+#include "ClimbingSystem/ClimbingSystem.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static TAutoConsoleVariable<bool> CVarClimbHeatmapEnable(
+	TEXT("srs.ClimbHeatmap.Enable"),
+	false,
+	TEXT("Aggregate climb failures and trace cost into a per-level grid. Read when the world is created."));
+
+static TAutoConsoleVariable<float> CVarClimbHeatmapCellSize(
+	TEXT("srs.ClimbHeatmap.CellSize"),
+	200.f,
+	TEXT("Edge length of a climb heatmap cell in centimetres."));
+
+static FAutoConsoleCommandWithWorldAndArgs ClimbHeatmapDumpCommand(
+	TEXT("srs.ClimbHeatmap.Dump"),
+	TEXT("Write the climb heatmap of this world to the given path, or to Saved/ClimbHeatmap."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (USRS_ClimbHeatmapSubsystem* Heatmap = World ? World->GetSubsystem<USRS_ClimbHeatmapSubsystem>() : nullptr)
+		{
+			const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("ClimbHeatmap") / (World->GetMapName() + TEXT(".srhm"));
+			Heatmap->DumpToFile(Path);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs ClimbHeatmapLoadCommand(
+	TEXT("srs.ClimbHeatmap.Load"),
+	TEXT("Load a climb heatmap dump into this world and draw it until cleared."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		USRS_ClimbHeatmapSubsystem* Heatmap = World ? World->GetSubsystem<USRS_ClimbHeatmapSubsystem>() : nullptr;
+		if (Heatmap && Args.Num() > 0 && Heatmap->LoadFromFile(Args[0]))
+		{
+			FlushPersistentDebugLines(World);
+			Heatmap->DrawCells(-1.f);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs ClimbHeatmapDrawCommand(
+	TEXT("srs.ClimbHeatmap.Draw"),
+	TEXT("Draw the climb heatmap of this world for the given number of seconds."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (USRS_ClimbHeatmapSubsystem* Heatmap = World ? World->GetSubsystem<USRS_ClimbHeatmapSubsystem>() : nullptr)
+		{
+			Heatmap->DrawCells(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.f);
+		}
+	}));
+
+void FSRS_ClimbHeatmapCell::Merge(const FSRS_ClimbHeatmapCell& Other)
+{
+	for (int32 Index = 0; Index < static_cast<int32>(ESRS_ClimbHeatmapEvent::Num); ++Index)
+	{
+		EventCounts[Index] += Other.EventCounts[Index];
+	}
+	TraceCount += Other.TraceCount;
+	TraceHitCount += Other.TraceHitCount;
+	TraceCycles += Other.TraceCycles;
+}
+
+uint32 FSRS_ClimbHeatmapCell::GetFailureCount() const
+{
+	uint32 Failures = 0;
+	for (const uint32 Count : EventCounts)
+	{
+		Failures += Count;
+	}
+	return Failures;
+}
+
+void USRS_ClimbHeatmapSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(CVarClimbHeatmapCellSize.GetValueOnGameThread(), 1.f);
+	const UWorld* World = GetWorld();
+	bRecording = CVarClimbHeatmapEnable.GetValueOnGameThread() && World && World->IsGameWorld();
+	if (bRecording)
+	{
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::OnWorldPostActorTick);
+	}
+}
+
+void USRS_ClimbHeatmapSubsystem::Deinitialize()
+{
+	if (bRecording)
+	{
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		MergeShards();
+		const FString FileName = FString::Printf(TEXT("%s_%s.srhm"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString());
+		DumpToFile(FPaths::ProjectSavedDir() / TEXT("ClimbHeatmap") / FileName);
+		bRecording = false;
+	}
+	Super::Deinitialize();
+}
+
+void USRS_ClimbHeatmapSubsystem::RecordEvent(const FVector& Location, ESRS_ClimbHeatmapEvent Event)
+{
+	FShard& Shard = GetShardForCurrentThread();
+	FScopeLock Lock(&Shard.Lock);
+	++Shard.Cells.FindOrAdd(GetCellKey(Location)).EventCounts[static_cast<int32>(Event)];
+}
+
+void USRS_ClimbHeatmapSubsystem::RecordTrace(const FVector& Location, int32 NumHits, uint64 Cycles)
+{
+	FShard& Shard = GetShardForCurrentThread();
+	FScopeLock Lock(&Shard.Lock);
+	FSRS_ClimbHeatmapCell& Cell = Shard.Cells.FindOrAdd(GetCellKey(Location));
+	++Cell.TraceCount;
+	Cell.TraceHitCount += NumHits;
+	Cell.TraceCycles += Cycles;
+}
+
+bool USRS_ClimbHeatmapSubsystem::DumpToFile(const FString& Path)
+{
+	MergeShards();
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	int32 NumCells = Cells.Num();
+	Writer << Magic << Version << CellSize << NumCells;
+	for (TPair<FIntVector, FSRS_ClimbHeatmapCell>& Pair : Cells)
+	{
+		Writer << Pair.Key.X << Pair.Key.Y << Pair.Key.Z;
+		for (uint32& Count : Pair.Value.EventCounts)
+		{
+			Writer << Count;
+		}
+		Writer << Pair.Value.TraceCount << Pair.Value.TraceHitCount << Pair.Value.TraceCycles;
+	}
+
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*FPaths::GetPath(Path));
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+	{
+		UE_LOG(LogClimbingSystem, Warning, TEXT("Climb heatmap could not be written to %s"), *Path);
+		return false;
+	}
+	return true;
+}
+
+bool USRS_ClimbHeatmapSubsystem::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path)) { return false; }
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 NumCells = 0;
+	Reader << Magic << Version;
+	if (Magic != FileMagic || Version != FileVersion) { return false; }
+	float FileCellSize = 0.f;
+	Reader << FileCellSize << NumCells;
+	if (Reader.IsError() || FileCellSize <= 0.f) { return false; }
+
+	TMap<FIntVector, FSRS_ClimbHeatmapCell> FileCells;
+	for (int32 Index = 0; Index < NumCells && !Reader.IsError(); ++Index)
+	{
+		FIntVector Key;
+		FSRS_ClimbHeatmapCell Cell;
+		Reader << Key.X << Key.Y << Key.Z;
+		for (uint32& Count : Cell.EventCounts)
+		{
+			Reader << Count;
+		}
+		Reader << Cell.TraceCount << Cell.TraceHitCount << Cell.TraceCycles;
+		FileCells.Add(Key, Cell);
+	}
+	if (Reader.IsError()) { return false; }
+	LoadedCells = MoveTemp(FileCells);
+	LoadedCellSize = FileCellSize;
+	return true;
+}
+
+void USRS_ClimbHeatmapSubsystem::DrawCells(float Duration) const
+{
+	if (!LoadedCells.IsEmpty())
+	{
+		DrawGrid(LoadedCells, LoadedCellSize, Duration);
+	}
+	else
+	{
+		DrawGrid(Cells, CellSize, Duration);
+	}
+}
+
+void USRS_ClimbHeatmapSubsystem::DrawGrid(const TMap<FIntVector, FSRS_ClimbHeatmapCell>& GridCells, float GridCellSize, float Duration) const
+{
+	const UWorld* World = GetWorld();
+	if (!World || GridCells.IsEmpty()) { return; }
+
+	uint64 MaxCycles = 1;
+	for (const TPair<FIntVector, FSRS_ClimbHeatmapCell>& Pair : GridCells)
+	{
+		MaxCycles = FMath::Max(MaxCycles, Pair.Value.TraceCycles);
+	}
+
+	const bool bPersistent = Duration < 0.f;
+	const FVector Extent(GridCellSize * 0.5f);
+	for (const TPair<FIntVector, FSRS_ClimbHeatmapCell>& Pair : GridCells)
+	{
+		const FSRS_ClimbHeatmapCell& Cell = Pair.Value;
+		const FVector Center = (FVector(Pair.Key) + 0.5f) * GridCellSize;
+		const float Cost = static_cast<float>(static_cast<double>(Cell.TraceCycles) / MaxCycles);
+		const FColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, Cost).ToFColor(true);
+		DrawDebugBox(World, Center, Extent * 0.95f, Color, bPersistent, Duration);
+
+		const uint32 Failures = Cell.GetFailureCount();
+		if (Failures > 0 || Cost > 0.5f)
+		{
+			const double Milliseconds = FPlatformTime::ToMilliseconds64(Cell.TraceCycles);
+			const FString Label = FString::Printf(TEXT("fail %u | traces %u | hits %u | %.2f ms"), Failures, Cell.TraceCount, Cell.TraceHitCount, Milliseconds);
+			DrawDebugString(World, Center, Label, nullptr, Color, Duration);
+		}
+	}
+}
+
+USRS_ClimbHeatmapSubsystem::FShard& USRS_ClimbHeatmapSubsystem::GetShardForCurrentThread()
+{
+	return Shards[FPlatformTLS::GetCurrentThreadId() % NumShards];
+}
+
+FIntVector USRS_ClimbHeatmapSubsystem::GetCellKey(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+void USRS_ClimbHeatmapSubsystem::MergeShards()
+{
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		for (const TPair<FIntVector, FSRS_ClimbHeatmapCell>& Pair : Shard.Cells)
+		{
+			Cells.FindOrAdd(Pair.Key).Merge(Pair.Value);
+		}
+		Shard.Cells.Reset();
+	}
+}
+
+void USRS_ClimbHeatmapSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld == GetWorld())
+	{
+		MergeShards();
+	}
+}
@@ -0,0 +1,224 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/SRS_ClimbTelemetry.h"
+
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	constexpr float NormalScale = 32767.f;
+	// Outside the quantized octahedral range, every encodable normal including +Z stays distinct from it
+	constexpr int32 ZeroNormal = MIN_int16;
+
+	float SignNotZero(float Value)
+	{
+		return Value >= 0.f ? 1.f : -1.f;
+	}
+
+	int32 QuantizeClamped(float Value, int32 Limit)
+	{
+		return FMath::Clamp(FMath::RoundToInt32(Value), -Limit, Limit);
+	}
+
+	uint32 ZigZag(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	int32 UnZigZag(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+
+	void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	void WriteVarDelta(TArray<uint8>& Out, int32 Current, int32 Previous)
+	{
+		WriteVarUInt(Out, ZigZag(Current - Previous));
+	}
+
+	struct FReader
+	{
+		const TArray<uint8>& Bytes;
+		int32 Offset;
+		int32 End;
+
+		bool ReadByte(uint8& OutValue)
+		{
+			if (Offset >= End) { return false; }
+			OutValue = Bytes[Offset++];
+			return true;
+		}
+
+		bool ReadUInt32(uint32& OutValue)
+		{
+			if (Offset + 4 > End) { return false; }
+			FMemory::Memcpy(&OutValue, Bytes.GetData() + Offset, 4);
+			Offset += 4;
+			return true;
+		}
+
+		bool ReadVarUInt(uint32& OutValue)
+		{
+			OutValue = 0;
+			for (int32 Shift = 0; Shift < 35; Shift += 7)
+			{
+				uint8 Byte;
+				if (!ReadByte(Byte)) { return false; }
+				OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+				if (!(Byte & 0x80)) { return true; }
+			}
+			return false;
+		}
+
+		bool ReadVarDelta(int32& InOutValue)
+		{
+			uint32 Encoded;
+			if (!ReadVarUInt(Encoded)) { return false; }
+			InOutValue += UnZigZag(Encoded);
+			return true;
+		}
+	};
+}
+
+FSRS_ClimbTelemetryQuantizedSample FSRS_ClimbTelemetryCodec::Quantize(const FSRS_ClimbTelemetrySample& Sample)
+{
+	FSRS_ClimbTelemetryQuantizedSample Out;
+	Out.Frame = Sample.Frame;
+	Out.TimeMs = Sample.TimeMs;
+	Out.MovementMode = Sample.MovementMode;
+	Out.CustomMovementMode = Sample.CustomMovementMode;
+	Out.Events = Sample.Events;
+
+	const FVector3f& N = Sample.SurfaceNormal;
+	const float L1 = FMath::Abs(N.X) + FMath::Abs(N.Y) + FMath::Abs(N.Z);
+	Out.Normal[0] = ZeroNormal;
+	Out.Normal[1] = ZeroNormal;
+	if (L1 > UE_SMALL_NUMBER)
+	{
+		float X = N.X / L1;
+		float Y = N.Y / L1;
+		if (N.Z < 0.f)
+		{
+			const float FoldedX = (1.f - FMath::Abs(Y)) * SignNotZero(X);
+			Y = (1.f - FMath::Abs(X)) * SignNotZero(Y);
+			X = FoldedX;
+		}
+		Out.Normal[0] = QuantizeClamped(X * NormalScale, MAX_int16);
+		Out.Normal[1] = QuantizeClamped(Y * NormalScale, MAX_int16);
+	}
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Out.Velocity[Axis] = QuantizeClamped(Sample.Velocity[Axis], MAX_int16);
+		Out.Location[Axis] = QuantizeClamped(Sample.Location[Axis], MAX_int32 / 2);
+	}
+	return Out;
+}
+
+FVector FSRS_ClimbTelemetryCodec::DecodeNormal(const FSRS_ClimbTelemetryQuantizedSample& Sample)
+{
+	if (Sample.Normal[0] == ZeroNormal) { return FVector::ZeroVector; }
+	float X = Sample.Normal[0] / NormalScale;
+	float Y = Sample.Normal[1] / NormalScale;
+	const float Z = 1.f - FMath::Abs(X) - FMath::Abs(Y);
+	if (Z < 0.f)
+	{
+		const float UnfoldedX = (1.f - FMath::Abs(Y)) * SignNotZero(X);
+		Y = (1.f - FMath::Abs(X)) * SignNotZero(Y);
+		X = UnfoldedX;
+	}
+	return FVector(X, Y, Z).GetSafeNormal();
+}
+
+void FSRS_ClimbTelemetryCodec::WriteFileHeader(TArray<uint8>& Out)
+{
+	const uint32 Header[2] = { FileMagic, FileVersion };
+	Out.Append(reinterpret_cast<const uint8*>(Header), sizeof(Header));
+}
+
+void FSRS_ClimbTelemetryCodec::EncodeRecord(TArray<uint8>& Out, uint32 ClimberId,
+	const FSRS_ClimbTelemetryQuantizedSample& Current, const FSRS_ClimbTelemetryQuantizedSample& Previous)
+{
+	WriteVarUInt(Out, ClimberId);
+	WriteVarDelta(Out, Current.Frame, Previous.Frame);
+	WriteVarDelta(Out, Current.TimeMs, Previous.TimeMs);
+	Out.Add(Current.MovementMode);
+	Out.Add(Current.CustomMovementMode);
+	Out.Add(Current.Events);
+	for (int32 Axis = 0; Axis < 2; ++Axis)
+	{
+		WriteVarDelta(Out, Current.Normal[Axis], Previous.Normal[Axis]);
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		WriteVarDelta(Out, Current.Velocity[Axis], Previous.Velocity[Axis]);
+	}
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		WriteVarDelta(Out, Current.Location[Axis], Previous.Location[Axis]);
+	}
+}
+
+bool FSRS_ClimbTelemetryCodec::ReadCapture(const FString& Path, TArray<FSRS_ClimbTelemetryRecord>& OutRecords)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path)) { return false; }
+
+	FReader Header { Bytes, 0, Bytes.Num() };
+	uint32 Magic, Version;
+	if (!Header.ReadUInt32(Magic) || !Header.ReadUInt32(Version)) { return false; }
+	if (Magic != FileMagic || Version != FileVersion) { return false; }
+
+	TMap<uint32, FSRS_ClimbTelemetryQuantizedSample> PreviousByClimber;
+	int32 Offset = Header.Offset;
+	while (Offset < Bytes.Num())
+	{
+		FReader ChunkHeader { Bytes, Offset, Bytes.Num() };
+		uint32 ChunkSize;
+		if (!ChunkHeader.ReadUInt32(ChunkSize) || ChunkHeader.Offset + static_cast<int64>(ChunkSize) > Bytes.Num()) { return false; }
+
+		FReader Chunk { Bytes, ChunkHeader.Offset, ChunkHeader.Offset + static_cast<int32>(ChunkSize) };
+		while (Chunk.Offset < Chunk.End)
+		{
+			FSRS_ClimbTelemetryRecord Record;
+			if (!Chunk.ReadVarUInt(Record.ClimberId)) { return false; }
+
+			FSRS_ClimbTelemetryQuantizedSample& Sample = Record.Sample;
+			Sample = PreviousByClimber.FindOrAdd(Record.ClimberId);
+			int32 Frame = Sample.Frame;
+			int32 TimeMs = Sample.TimeMs;
+			bool bOk = Chunk.ReadVarDelta(Frame) && Chunk.ReadVarDelta(TimeMs);
+			bOk = bOk && Chunk.ReadByte(Sample.MovementMode) && Chunk.ReadByte(Sample.CustomMovementMode) && Chunk.ReadByte(Sample.Events);
+			for (int32 Axis = 0; Axis < 2; ++Axis)
+			{
+				bOk = bOk && Chunk.ReadVarDelta(Sample.Normal[Axis]);
+			}
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				bOk = bOk && Chunk.ReadVarDelta(Sample.Velocity[Axis]);
+			}
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				bOk = bOk && Chunk.ReadVarDelta(Sample.Location[Axis]);
+			}
+			if (!bOk) { return false; }
+			Sample.Frame = Frame;
+			Sample.TimeMs = TimeMs;
+			// Only whole records are kept
+			PreviousByClimber.Add(Record.ClimberId, Sample);
+			OutRecords.Add(Record);
+		}
+		Offset = Chunk.End;
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/SRS_ClimbTelemetryCsvCommandlet.h"
+
+#include "ClimbingSystem/ClimbingSystem.h"
+#include "ClimbingSystem/Public/Telemetry/SRS_ClimbTelemetry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+USRS_ClimbTelemetryCsvCommandlet::USRS_ClimbTelemetryCsvCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USRS_ClimbTelemetryCsvCommandlet::Main(const FString& Params)
+{
+	FString InPath;
+	if (!FParse::Value(*Params, TEXT("In="), InPath))
+	{
+		UE_LOG(LogClimbingSystem, Error, TEXT("Usage: -run=SRS_ClimbTelemetryCsv -In=<capture.srct> [-Out=<capture.csv>]"));
+		return 1;
+	}
+	FString OutPath;
+	if (!FParse::Value(*Params, TEXT("Out="), OutPath))
+	{
+		OutPath = FPaths::ChangeExtension(InPath, TEXT("csv"));
+	}
+
+	TArray<FSRS_ClimbTelemetryRecord> Records;
+	if (!FSRS_ClimbTelemetryCodec::ReadCapture(InPath, Records))
+	{
+		UE_LOG(LogClimbingSystem, Error, TEXT("Failed to read climb telemetry capture %s"), *InPath);
+		return 1;
+	}
+
+	FString Csv = TEXT("ClimberId,Frame,TimeMs,MovementMode,CustomMovementMode,Events,LocationX,LocationY,LocationZ,VelocityX,VelocityY,VelocityZ,NormalX,NormalY,NormalZ\n");
+	for (const FSRS_ClimbTelemetryRecord& Record : Records)
+	{
+		const FSRS_ClimbTelemetryQuantizedSample& Sample = Record.Sample;
+		const FVector Normal = FSRS_ClimbTelemetryCodec::DecodeNormal(Sample);
+		Csv += FString::Printf(TEXT("%u,%u,%u,%u,%u,%u,%d,%d,%d,%d,%d,%d,%.4f,%.4f,%.4f\n"),
+			Record.ClimberId, Sample.Frame, Sample.TimeMs,
+			Sample.MovementMode, Sample.CustomMovementMode, Sample.Events,
+			Sample.Location[0], Sample.Location[1], Sample.Location[2],
+			Sample.Velocity[0], Sample.Velocity[1], Sample.Velocity[2],
+			Normal.X, Normal.Y, Normal.Z);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutPath))
+	{
+		UE_LOG(LogClimbingSystem, Error, TEXT("Failed to write %s"), *OutPath);
+		return 1;
+	}
+	UE_LOG(LogClimbingSystem, Display, TEXT("Wrote %d climb telemetry records to %s"), Records.Num(), *OutPath);
+	return 0;
+}
@@ -0,0 +1,160 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Telemetry/SRS_ClimbTelemetrySubsystem.h"
+
+#include "ClimbingSystem/ClimbingSystem.h"
+#include "ClimbingSystem/Public/Telemetry/SRS_ClimbTelemetry.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarClimbTelemetryEnable(
+	TEXT("srs.ClimbTelemetry.Enable"),
+	false,
+	TEXT("Record climb telemetry for every climber to Saved/ClimbTelemetry. Read when the world begins play."));
+
+class FSRS_ClimbTelemetryWriter : public FRunnable
+{
+public:
+	static constexpr int32 ChunkFlushSize = 64 * 1024;
+
+	explicit FSRS_ClimbTelemetryWriter(IFileHandle* InFile)
+		: File(InFile)
+	{
+		TArray<uint8> Header;
+		FSRS_ClimbTelemetryCodec::WriteFileHeader(Header);
+		File->Write(Header.GetData(), Header.Num());
+		Chunk.Reserve(ChunkFlushSize * 2);
+		Thread = FRunnableThread::Create(this, TEXT("SRS_ClimbTelemetryWriter"), 0, TPri_BelowNormal);
+	}
+
+	virtual ~FSRS_ClimbTelemetryWriter() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+			delete Thread;
+		}
+		Drain();
+		FlushChunk();
+	}
+
+	void AddStream(const TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>& Stream)
+	{
+		FScopeLock Lock(&StreamsLock);
+		Streams.Add(Stream);
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStopRequested.load(std::memory_order_relaxed))
+		{
+			Drain();
+			if (Chunk.Num() >= ChunkFlushSize)
+			{
+				FlushChunk();
+			}
+			FPlatformProcess::Sleep(0.005f);
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopRequested.store(true, std::memory_order_relaxed);
+	}
+
+private:
+	void Drain()
+	{
+		TArray<TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>> Snapshot;
+		{
+			FScopeLock Lock(&StreamsLock);
+			Snapshot = Streams;
+		}
+
+		FSRS_ClimbTelemetrySample Sample;
+		for (const TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>& Stream : Snapshot)
+		{
+			// Read retirement before draining so samples pushed just before it are not lost
+			const bool bRetired = Stream->bRetired.load(std::memory_order_acquire);
+			while (Stream->Pop(Sample))
+			{
+				const FSRS_ClimbTelemetryQuantizedSample Quantized = FSRS_ClimbTelemetryCodec::Quantize(Sample);
+				FSRS_ClimbTelemetryCodec::EncodeRecord(Chunk, Stream->ClimberId, Quantized, Stream->LastWritten);
+				Stream->LastWritten = Quantized;
+			}
+			if (bRetired)
+			{
+				FScopeLock Lock(&StreamsLock);
+				Streams.Remove(Stream);
+			}
+		}
+	}
+
+	void FlushChunk()
+	{
+		if (Chunk.IsEmpty()) { return; }
+		const uint32 ChunkSize = Chunk.Num();
+		File->Write(reinterpret_cast<const uint8*>(&ChunkSize), sizeof(ChunkSize));
+		File->Write(Chunk.GetData(), Chunk.Num());
+		File->Flush();
+		Chunk.Reset();
+	}
+
+	TUniquePtr<IFileHandle> File;
+	FRunnableThread* Thread { nullptr };
+	std::atomic<bool> bStopRequested { false };
+
+	FCriticalSection StreamsLock;
+	TArray<TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>> Streams;
+
+	TArray<uint8> Chunk;
+};
+
+void USRS_ClimbTelemetrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	if (!CVarClimbTelemetryEnable.GetValueOnGameThread()) { return; }
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("ClimbTelemetry");
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*Directory);
+
+	const FString FileName = FString::Printf(TEXT("%s_%s.srct"), *InWorld.GetMapName(), *FDateTime::Now().ToString());
+	IFileHandle* File = PlatformFile.OpenWrite(*(Directory / FileName));
+	if (!File)
+	{
+		UE_LOG(LogClimbingSystem, Warning, TEXT("Climb telemetry could not open %s for writing"), *FileName);
+		return;
+	}
+	Writer = MakeShared<FSRS_ClimbTelemetryWriter>(File);
+}
+
+void USRS_ClimbTelemetrySubsystem::Deinitialize()
+{
+	Writer.Reset();
+	Super::Deinitialize();
+}
+
+TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe> USRS_ClimbTelemetrySubsystem::RegisterClimber()
+{
+	if (!Writer) { return nullptr; }
+	TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe> Stream = MakeShared<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>(NextClimberId++);
+	Writer->AddStream(Stream);
+	return Stream;
+}
+
+void USRS_ClimbTelemetrySubsystem::UnregisterClimber(const TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>& Stream)
+{
+	if (!Stream) { return; }
+	Stream->bRetired.store(true, std::memory_order_release);
+}
+
+bool USRS_ClimbTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
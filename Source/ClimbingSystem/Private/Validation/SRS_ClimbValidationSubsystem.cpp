@@ -0,0 +1,264 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Validation/SRS_ClimbValidationSubsystem.h"
+
+#include "ClimbingSystem/ClimbingSystem.h"
+#include "ClimbingSystem/Public/Climbables/SRS_ClimbableSplineActor.h"
+#include "ClimbingSystem/Public/SRS_MovementComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarClimbValidationTraceBudget(
+	TEXT("srs.ClimbValidation.TraceBudget"),
+	8,
+	TEXT("Line traces the server may spend per frame checking escalated climb claims. Zero only runs the cheap invariants."));
+
+static FAutoConsoleCommandWithWorldAndArgs ClimbValidationDumpCommand(
+	TEXT("srs.ClimbValidation.Dump"),
+	TEXT("Log the climb validation verdicts of every player in this world."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (const USRS_ClimbValidationSubsystem* Validation = World ? World->GetSubsystem<USRS_ClimbValidationSubsystem>() : nullptr)
+		{
+			Validation->DumpStats();
+		}
+	}));
+
+namespace
+{
+	// Every trace check costs two line traces
+	constexpr int32 TracesPerCheck = 2;
+
+	bool ClaimPriorityPredicate(const FSRS_ClimbClaim& A, const FSRS_ClimbClaim& B)
+	{
+		return A.Priority > B.Priority;
+	}
+
+	const TCHAR* GetClaimTypeName(ESRS_ClimbClaimType Type)
+	{
+		switch (Type)
+		{
+		case ESRS_ClimbClaimType::ClimbDown:
+			return TEXT("climb down");
+		case ESRS_ClimbClaimType::Vault:
+			return TEXT("vault");
+		case ESRS_ClimbClaimType::Spline:
+			return TEXT("spline climb");
+		default:
+			return TEXT("climb");
+		}
+	}
+}
+
+void USRS_ClimbValidationSubsystem::Deinitialize()
+{
+	PendingChecks.Reset();
+	PlayerStats.Reset();
+	Super::Deinitialize();
+}
+
+TStatId USRS_ClimbValidationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USRS_ClimbValidationSubsystem, STATGROUP_Tickables);
+}
+
+bool USRS_ClimbValidationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool USRS_ClimbValidationSubsystem::SubmitClaim(const FSRS_ClimbClaim& Claim)
+{
+	FSRS_ClimbValidationStats& Stats = GetStats(Claim);
+	++Stats.Claims;
+
+	float Priority = 0.f;
+	const EVerdict Verdict = CheckInvariants(Claim, Stats, Priority);
+	Stats.LastClaimTime = Claim.Time;
+	if (Verdict == EVerdict::Reject)
+	{
+		++Stats.RejectedByInvariant;
+		RejectClaim(Claim, TEXT("invariant"), Stats);
+		return false;
+	}
+	if (Verdict == EVerdict::Accept && FMath::FRand() >= SpotCheckChance) { return true; }
+
+	if (PendingChecks.Num() >= MaxPendingChecks)
+	{
+		++Stats.Skipped;
+		return true;
+	}
+	++Stats.Escalated;
+	FSRS_ClimbClaim Pending = Claim;
+	Pending.Priority = Priority;
+	PendingChecks.HeapPush(MoveTemp(Pending), ClaimPriorityPredicate);
+	return true;
+}
+
+void USRS_ClimbValidationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	int32 TraceBudget = CVarClimbValidationTraceBudget.GetValueOnGameThread();
+	while (!PendingChecks.IsEmpty() && TraceBudget >= TracesPerCheck)
+	{
+		FSRS_ClimbClaim Claim;
+		PendingChecks.HeapPop(Claim, ClaimPriorityPredicate, EAllowShrinking::No);
+		FSRS_ClimbValidationStats& Stats = GetStats(Claim);
+		if (!Claim.Climber.IsValid())
+		{
+			++Stats.Skipped;
+			continue;
+		}
+		TraceBudget -= TracesPerCheck;
+		if (RunTraceCheck(Claim))
+		{
+			++Stats.PassedTrace;
+		}
+		else
+		{
+			++Stats.RejectedByTrace;
+			RejectClaim(Claim, TEXT("trace"), Stats);
+		}
+	}
+}
+
+USRS_ClimbValidationSubsystem::EVerdict USRS_ClimbValidationSubsystem::CheckInvariants(const FSRS_ClimbClaim& Claim,
+	const FSRS_ClimbValidationStats& Stats, float& OutPriority) const
+{
+	// The client may only claim geometry from about where the server has it
+	if (FVector::DistSquared(Claim.Location, Claim.ServerLocation) > FMath::Square(MaxClaimLocationError)) { return EVerdict::Reject; }
+
+	float Suspicion = 0.f;
+	switch (Claim.Type)
+	{
+	case ESRS_ClimbClaimType::Climb:
+	{
+		if (Claim.SurfaceNormal.IsNearlyZero()) { return EVerdict::Reject; }
+		if (FVector::DotProduct(Claim.SurfaceNormal, Claim.Up) >= FMath::Cos(FMath::DegreesToRadians(MaxFloorAngle))) { return EVerdict::Reject; }
+		const float SurfaceDistance = FMath::Abs(FVector::PointPlaneDist(Claim.Location, Claim.SurfaceLocation, Claim.SurfaceNormal));
+		if (SurfaceDistance > MaxSurfaceDistance) { return EVerdict::Reject; }
+		if (SurfaceDistance > SuspiciousSurfaceDistance) { Suspicion += 1.f; }
+		if (FVector::DotProduct(Claim.Forward, -Claim.SurfaceNormal) < 0.5f) { Suspicion += 1.f; }
+		break;
+	}
+	case ESRS_ClimbClaimType::Vault:
+	{
+		if (FVector::Dist(Claim.Location, Claim.VaultStart) > MaxVaultReach) { return EVerdict::Reject; }
+		if (FVector::Dist(Claim.VaultStart, Claim.VaultEnd) > MaxVaultLength) { return EVerdict::Reject; }
+		// Vaults carry the climber across and down, never up onto something higher
+		if (FVector::DotProduct(Claim.VaultEnd - Claim.VaultStart, Claim.Up) > 100.f) { Suspicion += 1.f; }
+		break;
+	}
+	case ESRS_ClimbClaimType::ClimbDown:
+		// Nothing cheap tells a ledge from flat ground, always worth a look once the budget allows
+		Suspicion += 0.5f;
+		break;
+	case ESRS_ClimbClaimType::Spline:
+	{
+		// The spline's geometry is known, the server's climber has to be within grabbing distance of it
+		const ASRS_ClimbableSplineActor* Spline = Claim.Spline.Get();
+		if (!Spline) { return EVerdict::Reject; }
+		const FVector GrabLocation = Spline->GetClimbTransform(Spline->FindClosestDistance(Claim.ServerLocation)).GetLocation();
+		if (FVector::DistSquared(GrabLocation, Claim.ServerLocation) > FMath::Square(MaxSplineGrabDistance)) { return EVerdict::Reject; }
+		break;
+	}
+	}
+
+	if (Stats.LastClaimTime >= 0.0 && Claim.Time - Stats.LastClaimTime < MinClaimInterval) { Suspicion += 1.f; }
+	// Players already caught once get checked first
+	Suspicion += FMath::Min(Stats.RejectedByTrace + Stats.RejectedByInvariant, 5) * 0.5f;
+
+	OutPriority = Suspicion;
+	return Suspicion > 0.f ? EVerdict::Escalate : EVerdict::Accept;
+}
+
+bool USRS_ClimbValidationSubsystem::RunTraceCheck(const FSRS_ClimbClaim& Claim) const
+{
+	const USRS_MovementComponent* Climber = Claim.Climber.Get();
+	FCollisionObjectQueryParams ObjectQueryParams;
+	for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : Climber->GetClimbObjectTypes())
+	{
+		ObjectQueryParams.AddObjectTypesToQuery(UEngineTypes::ConvertToCollisionChannel(ObjectType));
+	}
+	if (!ObjectQueryParams.IsValid()) { return true; }
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbValidation), false, Climber->GetOwner());
+	const UWorld* World = GetWorld();
+	FHitResult Hit;
+
+	switch (Claim.Type)
+	{
+	case ESRS_ClimbClaimType::Climb:
+	{
+		// The claimed surface has to be there and face the way the client said, and reachable from eye height as in CanClimb
+		const FVector SurfaceStart = Claim.SurfaceLocation + Claim.SurfaceNormal * 50.f;
+		const FVector SurfaceEnd = Claim.SurfaceLocation - Claim.SurfaceNormal * 50.f;
+		if (!World->LineTraceSingleByObjectType(Hit, SurfaceStart, SurfaceEnd, ObjectQueryParams, QueryParams)) { return false; }
+		if (FVector::DotProduct(Hit.ImpactNormal, Claim.SurfaceNormal) < 0.7f) { return false; }
+		const FVector EyeStart = Claim.ServerLocation + Claim.Up * Claim.EyeHeight;
+		return World->LineTraceTestByObjectType(EyeStart, EyeStart + Claim.Forward * 150.f, ObjectQueryParams, QueryParams);
+	}
+	case ESRS_ClimbClaimType::Vault:
+	{
+		// Both vault points have to rest on something
+		for (const FVector& Point : { Claim.VaultStart, Claim.VaultEnd })
+		{
+			if (!World->LineTraceTestByObjectType(Point + Claim.Up * 50.f, Point - Claim.Up * 50.f, ObjectQueryParams, QueryParams)) { return false; }
+		}
+		return true;
+	}
+	case ESRS_ClimbClaimType::ClimbDown:
+	{
+		// Ground just ahead, then a drop a little further out, as in CanClimbDown
+		const FVector GroundStart = Claim.ServerLocation + Claim.Forward * 20.f;
+		if (!World->LineTraceTestByObjectType(GroundStart, GroundStart - Claim.Up * 150.f, ObjectQueryParams, QueryParams)) { return false; }
+		const FVector LedgeStart = GroundStart + Claim.Forward * 50.f;
+		return !World->LineTraceTestByObjectType(LedgeStart, LedgeStart - Claim.Up * 200.f, ObjectQueryParams, QueryParams);
+	}
+	case ESRS_ClimbClaimType::Spline:
+		// Fully decided by the invariants
+		return true;
+	}
+	return true;
+}
+
+void USRS_ClimbValidationSubsystem::RejectClaim(const FSRS_ClimbClaim& Claim, const TCHAR* Reason, FSRS_ClimbValidationStats& Stats) const
+{
+	const APlayerState* Player = Claim.Player.Get();
+	UE_LOG(LogClimbingSystem, Warning, TEXT("Rejected %s claim by %s at %s (%s check)"),
+		GetClaimTypeName(Claim.Type), Player ? *Player->GetPlayerName() : TEXT("unknown player"), *Claim.Location.ToCompactString(), Reason);
+
+	USRS_MovementComponent* Climber = Claim.Climber.Get();
+	if (!Climber) { return; }
+	// A late trace verdict must not abort whatever the climber has started since
+	if (Climber->GetClimbTransitionSequence() != Claim.TransitionSequence)
+	{
+		++Stats.Stale;
+		return;
+	}
+	Climber->RejectClimbTransition();
+}
+
+FSRS_ClimbValidationStats& USRS_ClimbValidationSubsystem::GetStats(const FSRS_ClimbClaim& Claim)
+{
+	return PlayerStats.FindOrAdd(Claim.Player.Get());
+}
+
+const FSRS_ClimbValidationStats* USRS_ClimbValidationSubsystem::FindStats(const APlayerState* Player) const
+{
+	return PlayerStats.Find(Player);
+}
+
+void USRS_ClimbValidationSubsystem::DumpStats() const
+{
+	UE_LOG(LogClimbingSystem, Log, TEXT("Climb validation: %d checks pending"), PendingChecks.Num());
+	for (const TPair<APlayerState*, FSRS_ClimbValidationStats>& Entry : PlayerStats)
+	{
+		const FSRS_ClimbValidationStats& Stats = Entry.Value;
+		UE_LOG(LogClimbingSystem, Log, TEXT("  %s: %d claims, %d escalated, %d passed trace, %d rejected by invariant, %d rejected by trace (%d stale), %d skipped"),
+			Entry.Key ? *Entry.Key->GetPlayerName() : TEXT("unknown player"),
+			Stats.Claims, Stats.Escalated, Stats.PassedTrace, Stats.RejectedByInvariant, Stats.RejectedByTrace, Stats.Stale, Stats.Skipped);
+	}
+}
@@ -8,7 +8,29 @@
 
 
 class USRS_MovementComponent;
-class AClimbingSystemCharacter;
+class ASRS_ClimberCharacter;
+
+// Blend weights of the climb key poses, summing to one
+USTRUCT(BlueprintType)
+struct FSRS_ClimbPoseWeights
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	float Idle { 1.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	float Up { 0.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	float Down { 0.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	float Left { 0.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	float Right { 0.f };
+};
 
 UCLASS()
 class CLIMBINGSYSTEM_API USRS_AnimInstance : public UAnimInstance
@@ -23,7 +45,7 @@ protected:
 
 private:
 	UPROPERTY()
-	AClimbingSystemCharacter* ClimbingSystemCharacter;
+	ASRS_ClimberCharacter* ClimbingSystemCharacter;
 
 	UPROPERTY()
 	USRS_MovementComponent* CustomMovementComponent;
@@ -53,8 +75,40 @@ private:
 
 	void GetIsClimbing();
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	bool bIsLedgeHanging { false };
+
+	void GetIsLedgeHanging();
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
 	FVector ClimbVelocity { FVector::ZeroVector };
 
 	void GetClimbVelocity();
+
+	// Procedural climb locomotion: a handful of key poses blended by direction and phase instead of a clip per direction
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	FSRS_ClimbPoseWeights ClimbPoseWeights;
+
+	// Position in the climb cycle, 0 to 0.5 reaching with the left hand and 0.5 to 1 with the right
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float ClimbStridePhase { 0.f };
+
+	// 0 with the left limbs reaching, 1 with the right, eased between them over the cycle
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbAlternation { 0.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float ClimbDistanceTravelled { 0.f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float ClimbStopDistance { 0.f };
+
+	// Surface distance covered by one full climb cycle
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "1.0"))
+	float ClimbStrideLength { 40.f };
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbPoseBlendSpeed { 10.f };
+
+	void GetClimbLocomotion(float DeltaSeconds);
 };
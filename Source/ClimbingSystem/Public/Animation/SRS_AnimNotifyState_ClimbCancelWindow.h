@@ -0,0 +1,17 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/SRS_AnimNotifyState_ClimbWindow.h"
+#include "SRS_AnimNotifyState_ClimbCancelWindow.generated.h"
+
+// Montage section during which a buffered climb press may interrupt the montage instead of waiting for it to end
+UCLASS(meta = (DisplayName = "Climb Cancel Window"))
+class CLIMBINGSYSTEM_API USRS_AnimNotifyState_ClimbCancelWindow : public USRS_AnimNotifyState_ClimbWindow
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void SetWindowOpen(USRS_MovementComponent* Movement, bool bOpen) const override;
+};
@@ -0,0 +1,17 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/SRS_AnimNotifyState_ClimbWindow.h"
+#include "SRS_AnimNotifyState_ClimbInputWindow.generated.h"
+
+// Montage section during which climb presses stay buffered without expiring, so a chain can be queued early
+UCLASS(meta = (DisplayName = "Climb Input Window"))
+class CLIMBINGSYSTEM_API USRS_AnimNotifyState_ClimbInputWindow : public USRS_AnimNotifyState_ClimbWindow
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void SetWindowOpen(USRS_MovementComponent* Movement, bool bOpen) const override;
+};
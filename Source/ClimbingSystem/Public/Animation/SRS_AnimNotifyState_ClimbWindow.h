@@ -0,0 +1,26 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "SRS_AnimNotifyState_ClimbWindow.generated.h"
+
+class USRS_MovementComponent;
+
+// Montage section that holds one of the climb movement component's input windows open while it plays
+UCLASS(Abstract)
+class CLIMBINGSYSTEM_API USRS_AnimNotifyState_ClimbWindow : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override;
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+
+protected:
+	virtual void SetWindowOpen(USRS_MovementComponent* Movement, bool bOpen) const PURE_VIRTUAL(USRS_AnimNotifyState_ClimbWindow::SetWindowOpen, );
+
+private:
+	static USRS_MovementComponent* GetClimbMovement(const USkeletalMeshComponent* MeshComp);
+};
@@ -0,0 +1,82 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SRS_BakedRootMotion.generated.h"
+
+class UAnimMontage;
+
+// Section of a baked track during which root motion is warped towards a motion warping target
+USTRUCT()
+struct FSRS_BakedWarpWindow
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	FName WarpTargetName;
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	float StartTime { 0.f };
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	float EndTime { 0.f };
+};
+
+// Root motion of one montage sampled at a fixed rate, cumulative from the montage start in mesh space
+USTRUCT()
+struct CLIMBINGSYSTEM_API FSRS_BakedRootMotionTrack
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Root Motion")
+	TSoftObjectPtr<UAnimMontage> Montage;
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	float SampleRate { 30.f };
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	float Duration { 0.f };
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	TArray<FVector3f> Translations;
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	TArray<FQuat4f> Rotations;
+
+	UPROPERTY(VisibleAnywhere, Category = "Root Motion")
+	TArray<FSRS_BakedWarpWindow> WarpWindows;
+
+	FTransform Sample(float Time) const;
+	FTransform ExtractDelta(float StartTime, float EndTime) const;
+	const FSRS_BakedWarpWindow* FindWarpWindow(float Time) const;
+};
+
+/**
+ * Root motion baked out of the climb montages so servers can move climbers without evaluating their skeletal meshes.
+ * Tracks are rebaked when the asset is cooked, or on demand from the editor.
+ */
+UCLASS(BlueprintType)
+class CLIMBINGSYSTEM_API USRS_BakedRootMotionSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	const FSRS_BakedRootMotionTrack* FindTrack(const FSoftObjectPath& MontagePath) const;
+	bool HasTracksFor(TConstArrayView<FSoftObjectPath> MontagePaths) const;
+
+#if WITH_EDITOR
+	UFUNCTION(CallInEditor, Category = "Root Motion")
+	void BakeTracks();
+
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+#endif
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Root Motion", meta = (ClampMin = "1.0"))
+	float BakeSampleRate { 30.f };
+
+	UPROPERTY(EditAnywhere, Category = "Root Motion")
+	TArray<FSRS_BakedRootMotionTrack> Tracks;
+};
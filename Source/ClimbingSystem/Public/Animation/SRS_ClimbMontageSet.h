@@ -0,0 +1,57 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SRS_ClimbMontageSet.generated.h"
+
+class UAnimMontage;
+
+UENUM(BlueprintType)
+enum class ESRS_ClimbMontage : uint8
+{
+	IdleToClimb,
+	ClimbUpLedge,
+	ClimbDownLedge,
+	Vault,
+	HopUp,
+	HopDown,
+	Count UMETA(Hidden)
+};
+
+// Climb montages held by soft reference so they are only resident while climbers are near something climbable
+UCLASS(BlueprintType)
+class CLIMBINGSYSTEM_API USRS_ClimbMontageSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	const TSoftObjectPtr<UAnimMontage>& GetSoftMontage(ESRS_ClimbMontage Montage) const;
+
+	// Null until the montage has been loaded
+	UAnimMontage* GetLoadedMontage(ESRS_ClimbMontage Montage) const;
+	bool FindMontage(const UAnimMontage* Montage, ESRS_ClimbMontage& OutMontage) const;
+
+	TArray<FSoftObjectPath> GetMontagePaths() const;
+	bool AreMontagesLoaded() const;
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> IdleToClimb;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> ClimbUpLedge;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> ClimbDownLedge;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> Vault;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> HopUp;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TSoftObjectPtr<UAnimMontage> HopDown;
+};
@@ -0,0 +1,71 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimberSpacingSubsystem.generated.h"
+
+class USRS_MovementComponent;
+
+/**
+ * Spatial hash of climber anchors, projected onto each climber's wall plane, rebuilt once per frame so climbers sharing a wall
+ * can push apart without blocking each other's capsules. Queries read the hash built at the end of the previous frame.
+ */
+UCLASS(config=Game)
+class CLIMBINGSYSTEM_API USRS_ClimberSpacingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterClimber(USRS_MovementComponent* Climber);
+	void UnregisterClimber(USRS_MovementComponent* Climber);
+
+	// Sum of in-plane pushes away from neighbours on the same wall within SeparationRadius, each scaled from one at contact to zero at the radius
+	FVector ComputeSeparation(const USRS_MovementComponent* Climber, const FVector& Anchor, const FVector& SurfaceNormal) const;
+
+	static FVector ProjectAnchor(const FVector& Location, const FVector& SurfaceLocation, const FVector& SurfaceNormal);
+
+	FORCEINLINE float GetSeparationRadius() const { return SeparationRadius; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FAnchor
+	{
+		FVector Location { FVector::ZeroVector };
+		FVector SurfaceNormal { FVector::ZeroVector };
+		const USRS_MovementComponent* Climber { nullptr };
+	};
+
+	struct FCellRange
+	{
+		int32 Start { 0 };
+		int32 Num { 0 };
+	};
+
+	FIntVector GetCell(const FVector& Location) const;
+	static uint64 GetCellKey(const FIntVector& Cell);
+	void Rebuild();
+
+	// Also the hash cell size, so every neighbour within the radius is in the 27 cells around a climber
+	UPROPERTY(Config)
+	float SeparationRadius { 120.f };
+
+	// Neighbours whose wall normal is further off than this are on another face, around a corner or across a gap
+	UPROPERTY(Config)
+	float MinSharedWallDot { 0.7f };
+
+	UPROPERTY()
+	TArray<USRS_MovementComponent*> Climbers;
+
+	// Anchors sorted by cell key, with the range of each occupied cell
+	TArray<FAnchor> Anchors;
+	TArray<uint64> AnchorKeys;
+	TMap<uint64, FCellRange> CellRanges;
+};
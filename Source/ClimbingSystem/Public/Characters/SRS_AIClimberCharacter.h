@@ -0,0 +1,25 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Characters/SRS_ClimberCharacter.h"
+#include "SRS_AIClimberCharacter.generated.h"
+
+// AI climber without camera or input components, recycled through USRS_ClimberPoolSubsystem
+UCLASS()
+class CLIMBINGSYSTEM_API ASRS_AIClimberCharacter : public ASRS_ClimberCharacter
+{
+	GENERATED_BODY()
+
+public:
+	ASRS_AIClimberCharacter(const FObjectInitializer& ObjectInitializer);
+
+	void OnAcquiredFromPool(const FTransform& SpawnTransform, AController* InController = nullptr);
+	void OnReturnedToPool();
+
+	FORCEINLINE bool IsPooled() const { return bIsPooled; }
+
+private:
+	bool bIsPooled { false };
+};
@@ -0,0 +1,33 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "SRS_ClimberCharacter.generated.h"
+
+class USRS_MovementComponent;
+class UMotionWarpingComponent;
+
+// Climbing core shared by player and AI climbers: the custom movement component and motion warping, no camera or input
+UCLASS(Abstract)
+class CLIMBINGSYSTEM_API ASRS_ClimberCharacter : public ACharacter
+{
+	GENERATED_BODY()
+
+public:
+	ASRS_ClimberCharacter(const FObjectInitializer& ObjectInitializer);
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	USRS_MovementComponent* CustomMovementComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	UMotionWarpingComponent* MotionWarpingComponent;
+
+public:
+	/** Returns CustomMovementComponent subobject **/
+	FORCEINLINE  USRS_MovementComponent* GetCustomMovementComponent() const { return CustomMovementComponent; }
+	/** Returns MotionWarpingComponent subobject **/
+	FORCEINLINE  UMotionWarpingComponent* GetMotionWarpingComponent() const { return MotionWarpingComponent; }
+};
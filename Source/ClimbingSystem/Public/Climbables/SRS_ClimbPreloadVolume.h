@@ -0,0 +1,18 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/TriggerVolume.h"
+#include "SRS_ClimbPreloadVolume.generated.h"
+
+// Climbing-enabled region: climbers inside keep their climb montages streamed in regardless of nearby geometry
+UCLASS()
+class CLIMBINGSYSTEM_API ASRS_ClimbPreloadVolume : public ATriggerVolume
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+	virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
+};
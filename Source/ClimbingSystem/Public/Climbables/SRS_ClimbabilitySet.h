@@ -0,0 +1,78 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SRS_ClimbabilitySet.generated.h"
+
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ESRS_ClimbMove : uint8
+{
+	None = 0 UMETA(Hidden),
+	Climb = 1 << 0,
+	Hop = 1 << 1,
+	LedgeHang = 1 << 2,
+	Vault = 1 << 3,
+	ClimbDown = 1 << 4
+};
+ENUM_CLASS_FLAGS(ESRS_ClimbMove)
+
+// How a kind of surface climbs: what it is matched by, how fast it is climbed and which moves it allows
+USTRUCT(BlueprintType)
+struct CLIMBINGSYSTEM_API FSRS_ClimbabilityClass
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	FName Name;
+
+	// Primitives carrying this tag get the class, checked before the physical material
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	FName ComponentTag;
+
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	UPhysicalMaterial* PhysicalMaterial { nullptr };
+
+	UPROPERTY(EditAnywhere, Category = "Climbing", meta = (ClampMin = "0.0"))
+	float SpeedMultiplier { 1.f };
+
+	UPROPERTY(EditAnywhere, Category = "Climbing", meta = (ClampMin = "0.0"))
+	float AccelerationMultiplier { 1.f };
+
+	// Surfaces within this angle of up are floors and climbers let go of them
+	UPROPERTY(EditAnywhere, Category = "Climbing", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+	float MaxFloorAngle { 60.f };
+
+	UPROPERTY(EditAnywhere, Category = "Climbing", meta = (Bitmask, BitmaskEnum = "/Script/ClimbingSystem.ESRS_ClimbMove"))
+	uint8 AllowedMoves { MAX_uint8 };
+
+	FORCEINLINE bool AllowsMove(ESRS_ClimbMove Move) const { return (AllowedMoves & static_cast<uint8>(Move)) != 0; }
+};
+
+/**
+ * Climbability classes for surfaces, matched per primitive by component tag or physical material. A primitive resolves
+ * to a compact class id once, movement components cache the id so climbing never queries materials per hit.
+ */
+UCLASS(BlueprintType)
+class CLIMBINGSYSTEM_API USRS_ClimbabilitySet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Id 0 is the default class, the classes in the set follow from 1
+	uint8 ResolveClassId(const UPrimitiveComponent* Component) const;
+	const FSRS_ClimbabilityClass& GetClass(uint8 ClassId) const;
+
+private:
+	// Applies to everything no class matches
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	FSRS_ClimbabilityClass DefaultClass;
+
+	// First match wins, classes past the 255th are ignored
+	UPROPERTY(EditAnywhere, Category = "Climbing")
+	TArray<FSRS_ClimbabilityClass> Classes;
+};
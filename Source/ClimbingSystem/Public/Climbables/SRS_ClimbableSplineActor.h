@@ -0,0 +1,65 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SRS_ClimbableSplineActor.generated.h"
+
+class USplineComponent;
+class UBoxComponent;
+
+/**
+ * Ladder, rope or pipe whose climbable line is authored as a spline. Climbers inside the trigger attach to the spline and move along it
+ * by distance instead of sweeping for surfaces. The spline runs bottom to top and its up vector points away from the climbable face.
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API ASRS_ClimbableSplineActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASRS_ClimbableSplineActor();
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	float GetSplineLength() const;
+	float FindClosestDistance(const FVector& WorldLocation) const;
+	FTransform GetClimbTransform(float Distance) const;
+	FORCEINLINE float GetClimbOffset() const { return ClimbOffset; }
+
+	FORCEINLINE FVector GetTopExitLocation() const { return GetActorTransform().TransformPosition(TopExitLocation); }
+	FORCEINLINE FVector GetBottomExitLocation() const { return GetActorTransform().TransformPosition(BottomExitLocation); }
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	UFUNCTION()
+	void OnTriggerBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnTriggerEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	USplineComponent* ClimbSpline;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* ClimbTrigger;
+
+	// Distance from the spline to the climber's capsule centre, along the spline's up vector
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float ClimbOffset { 45.f };
+
+	// How far around the spline climbers can grab it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	float TriggerExtent { 80.f };
+
+	// Where the climber is placed when leaving over the top, relative to the actor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
+	FVector TopExitLocation { -60.f, 0.f, 496.f };
+
+	// Where the climber is placed when stepping off the bottom, relative to the actor
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
+	FVector BottomExitLocation { 60.f, 0.f, 96.f };
+};
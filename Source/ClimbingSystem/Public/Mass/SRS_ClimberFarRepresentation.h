@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Actor.h"
+#include "SRS_ClimberFarRepresentation.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+// Quantised pose of one demoted climber as sent to clients
+USTRUCT()
+struct FSRS_FarClimberInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Forward;
+};
+
+/**
+ * Instanced stand-ins for the climbers USRS_ClimberLODSubsystem has demoted. The server owns the instance list and replicates it,
+ * so clients draw the demoted climbers too although the Mass simulation only runs on the server.
+ */
+UCLASS(NotPlaceable, Transient)
+class CLIMBINGSYSTEM_API ASRS_ClimberFarRepresentation : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASRS_ClimberFarRepresentation();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	void SetInstances(TArray<FSRS_FarClimberInstance>&& NewInstances);
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	UFUNCTION()
+	void OnRep_ClimberInstances();
+
+	void UpdateInstances();
+
+	UPROPERTY(VisibleAnywhere, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	UInstancedStaticMeshComponent* InstancedMesh;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ClimberInstances)
+	TArray<FSRS_FarClimberInstance> ClimberInstances;
+};
@@ -0,0 +1,77 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimberLODSubsystem.generated.h"
+
+class ACharacter;
+class AController;
+class ASRS_ClimberFarRepresentation;
+class UStaticMesh;
+
+/**
+ * Demotes distant AI climbers to Mass entities simulated by USRS_ClimberSimulationProcessor and promotes them back
+ * to full characters, carrying the climb state across, once a local viewer gets close again.
+ */
+UCLASS(config=Game)
+class CLIMBINGSYSTEM_API USRS_ClimberLODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterClimber(ACharacter* Climber);
+	void UnregisterClimber(ACharacter* Climber);
+
+	FORCEINLINE int32 GetNumSimulatedClimbers() const { return SimulatedClimbers.Num(); }
+	FORCEINLINE const TSoftObjectPtr<UStaticMesh>& GetFarClimberMesh() const { return FarClimberMesh; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void GatherViewLocations();
+	float GetClosestViewDistanceSquared(const FVector& Location) const;
+	bool CanDemote(const ACharacter* Climber) const;
+	void Demote(ACharacter* Climber);
+	void Promote(int32 SimulatedIndex);
+	ACharacter* SpawnClimber(TSubclassOf<ACharacter> CharacterClass, const FTransform& SpawnTransform, AController* Controller) const;
+	void UpdateFarRepresentation();
+
+	// Full characters further than this from every local viewer are demoted
+	UPROPERTY(Config)
+	float DemoteDistance { 6000.f };
+
+	// Demoted climbers closer than this to any local viewer are promoted, keep below DemoteDistance for hysteresis
+	UPROPERTY(Config)
+	float PromoteDistance { 5000.f };
+
+	UPROPERTY(Config)
+	float LODUpdateInterval { 0.25f };
+
+	// Optional instanced mesh drawn in place of demoted climbers, on the server and on every client
+	UPROPERTY(Config)
+	TSoftObjectPtr<UStaticMesh> FarClimberMesh;
+
+	UPROPERTY()
+	TArray<ACharacter*> FullClimbers;
+
+	// Keeps the classes of demoted climbers alive until they are promoted again
+	UPROPERTY()
+	TSet<UClass*> SimulatedClimberClasses;
+
+	UPROPERTY()
+	ASRS_ClimberFarRepresentation* FarRepresentation;
+
+	TArray<FMassEntityHandle> SimulatedClimbers;
+	TArray<FVector> ViewLocations;
+	FMassArchetypeHandle ClimberArchetype;
+	float TimeUntilLODUpdate { 0.f };
+};
@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "SRS_ClimberMassFragments.generated.h"
+
+class ACharacter;
+class AController;
+
+// Wall-relative state of a climber that has been demoted out of its full character
+USTRUCT()
+struct CLIMBINGSYSTEM_API FSRS_ClimbAnchorFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FVector SurfaceLocation { FVector::ZeroVector };
+	FVector SurfaceNormal { FVector::ZeroVector };
+	FVector Velocity { FVector::ZeroVector };
+
+	// Signed distance of the pawn from the surface plane, kept constant while simulated
+	float PlaneOffset { 0.f };
+
+	// World bounds of the climbed primitive, the simulated climber stops at its edges
+	FBox ClimbBounds { ForceInit };
+
+	// Climbing braking deceleration at demotion, the simulated climber settles to a stop at this rate
+	float BrakingDeceleration { 0.f };
+
+	TEnumAsByte<EMovementMode> MovementMode { MOVE_Walking };
+	uint8 CustomMovementMode { 0 };
+};
+
+// What to spawn when the climber is promoted back to a full character
+USTRUCT()
+struct CLIMBINGSYSTEM_API FSRS_ClimberRepresentationFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<ACharacter> CharacterClass;
+
+	// Unpossessed controller kept alive while demoted so its brain and blackboard survive the round trip
+	UPROPERTY()
+	TWeakObjectPtr<AController> Controller;
+};
@@ -0,0 +1,27 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "SRS_ClimberSimulationProcessor.generated.h"
+
+/**
+ * Brakes demoted climbers to a stop along their wall plane in bulk. No traces: the plane and the climbed primitive's bounds
+ * captured at demotion are all the geometry it knows about.
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API USRS_ClimberSimulationProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	USRS_ClimberSimulationProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,124 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cmath>
+
+/**
+ * Engine-independent climb geometry used by USRS_MovementComponent. Only depends on the C++ standard library
+ * so it can be tested and benchmarked on its own, see Tests/ClimbKernels.
+ */
+namespace SRS::ClimbKernels
+{
+	struct FVec3
+	{
+		double X { 0.0 };
+		double Y { 0.0 };
+		double Z { 0.0 };
+	};
+
+	inline FVec3 operator+(const FVec3& A, const FVec3& B) { return { A.X + B.X, A.Y + B.Y, A.Z + B.Z }; }
+	inline FVec3 operator-(const FVec3& A, const FVec3& B) { return { A.X - B.X, A.Y - B.Y, A.Z - B.Z }; }
+	inline FVec3 operator-(const FVec3& A) { return { -A.X, -A.Y, -A.Z }; }
+	inline FVec3 operator*(const FVec3& A, double Scale) { return { A.X * Scale, A.Y * Scale, A.Z * Scale }; }
+
+	inline double Dot(const FVec3& A, const FVec3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+	inline double SizeSquared(const FVec3& A) { return Dot(A, A); }
+	inline bool IsZero(const FVec3& A) { return A.X == 0.0 && A.Y == 0.0 && A.Z == 0.0; }
+
+	// Matches FVector::GetSafeNormal: vectors shorter than the tolerance normalise to zero
+	inline FVec3 SafeNormal(const FVec3& A, double Tolerance = 1.e-8)
+	{
+		const double SquareSum = SizeSquared(A);
+		if (SquareSum == 1.0) { return A; }
+		if (SquareSum < Tolerance) { return {}; }
+		return A * (1.0 / std::sqrt(SquareSum));
+	}
+
+	inline double DegreesToCos(double Degrees)
+	{
+		return std::cos(Degrees * (3.14159265358979323846 / 180.0));
+	}
+
+	// Running average of swept surface hits
+	struct FSurfaceAccumulator
+	{
+		FVec3 LocationSum;
+		FVec3 NormalSum;
+		int Count { 0 };
+
+		void Add(const FVec3& ImpactPoint, const FVec3& ImpactNormal)
+		{
+			LocationSum = LocationSum + ImpactPoint;
+			NormalSum = NormalSum + ImpactNormal;
+			++Count;
+		}
+
+		FVec3 GetLocation() const { return Count > 0 ? LocationSum * (1.0 / Count) : FVec3 {}; }
+		FVec3 GetNormal() const { return SafeNormal(NormalSum); }
+	};
+
+	// True when the surface is within MaxAngle of Up, i.e. a floor rather than a wall. Compares cosines instead of taking an acos.
+	inline bool IsSurfaceTooFlat(const FVec3& SurfaceNormal, const FVec3& Up, double CosMaxAngle)
+	{
+		return Dot(SurfaceNormal, Up) >= CosMaxAngle;
+	}
+
+	// Correction towards the surface: the forward distance to the surface, applied against the surface normal
+	inline FVec3 ComputeSnapVector(const FVec3& SurfaceLocation, const FVec3& ComponentLocation, const FVec3& ComponentForward, const FVec3& SurfaceNormal)
+	{
+		const double ForwardSizeSquared = SizeSquared(ComponentForward);
+		if (ForwardSizeSquared <= 0.0) { return {}; }
+		const double Distance = std::fabs(Dot(SurfaceLocation - ComponentLocation, ComponentForward)) / std::sqrt(ForwardSizeSquared);
+		return -SurfaceNormal * Distance;
+	}
+
+	enum class EHopDirection : unsigned char
+	{
+		None,
+		Up,
+		Down,
+		Right,
+		Left
+	};
+
+	// LocalDirection is the input in the component frame, Right is compared against it as given
+	inline EHopDirection ClassifyHop(const FVec3& LocalDirection, const FVec3& Right, double Threshold = 0.9)
+	{
+		const FVec3 Direction = SafeNormal(LocalDirection);
+		const double UpDot = Direction.Z;
+		const double SideDot = Dot(Direction, Right);
+		if (UpDot >= Threshold) { return EHopDirection::Up; }
+		if (UpDot <= -Threshold) { return EHopDirection::Down; }
+		if (SideDot >= Threshold) { return EHopDirection::Right; }
+		if (SideDot <= -Threshold) { return EHopDirection::Left; }
+		return EHopDirection::None;
+	}
+
+	constexpr int VaultProbeCount = 5;
+
+	// Downward probe I of the vault scan: each one a step further forward and reaching further down
+	inline void GetVaultProbe(int Index, const FVec3& Location, const FVec3& Forward, const FVec3& Up, FVec3& OutStart, FVec3& OutEnd)
+	{
+		const double Step = 100.0 * (Index + 1);
+		OutStart = Location + Up * 100.0 + Forward * Step;
+		OutEnd = OutStart - Up * Step;
+	}
+
+	struct FVaultProbeResult
+	{
+		bool bBlockingHit { false };
+		FVec3 ImpactPoint;
+	};
+
+	// The vault runs from the first probe's hit to the last probe's hit, both must have landed
+	inline bool SelectVaultPoints(const FVaultProbeResult* Probes, int Count, FVec3& OutStart, FVec3& OutEnd)
+	{
+		OutStart = {};
+		OutEnd = {};
+		if (Count <= 0) { return false; }
+		if (Probes[0].bBlockingHit) { OutStart = Probes[0].ImpactPoint; }
+		if (Probes[Count - 1].bBlockingHit) { OutEnd = Probes[Count - 1].ImpactPoint; }
+		return !IsZero(OutStart) && !IsZero(OutEnd);
+	}
+}
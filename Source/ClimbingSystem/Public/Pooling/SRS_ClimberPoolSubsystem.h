@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimberPoolSubsystem.generated.h"
+
+class AController;
+class ASRS_AIClimberCharacter;
+
+USTRUCT()
+struct FSRS_ClimberPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<ASRS_AIClimberCharacter*> Climbers;
+};
+
+// Recycles AI climbers per class instead of spawning and destroying them
+UCLASS(config=Game)
+class CLIMBINGSYSTEM_API USRS_ClimberPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Controller, when given, possesses the climber in place of a default controller
+	ASRS_AIClimberCharacter* AcquireClimber(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass, const FTransform& SpawnTransform, AController* Controller = nullptr);
+	void ReleaseClimber(ASRS_AIClimberCharacter* Climber);
+	void Prewarm(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass, int32 Count);
+
+	int32 GetNumPooled(TSubclassOf<ASRS_AIClimberCharacter> ClimberClass) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Climbers released beyond this per class are destroyed
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass { 64 };
+
+	UPROPERTY()
+	TMap<UClass*, FSRS_ClimberPoolBucket> Pools;
+};
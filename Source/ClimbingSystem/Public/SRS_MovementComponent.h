@@ -4,14 +4,30 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "ClimbingSystem/Public/Validation/SRS_ClimbValidationSubsystem.h"
+#include "Misc/TVariant.h"
 #include "SRS_MovementComponent.generated.h"
 
 DECLARE_DELEGATE(FOnEnterClimbState)
 DECLARE_DELEGATE(FOnExitClimbState)
 
-class AClimbingSystemCharacter;
+class ASRS_ClimberCharacter;
 class UAnimMontage;
 class UAnimInstance;
+struct FSRS_ClimbTelemetryStream;
+enum class ESRS_ClimbTelemetryEvent : uint8;
+enum class ESRS_ClimbHeatmapEvent : uint8;
+class USRS_ClimbHeatmapSubsystem;
+class USRS_ClimberSpacingSubsystem;
+class USRS_BakedRootMotionSet;
+class USRS_ClimbMontageSet;
+enum class ESRS_ClimbMontage : uint8;
+struct FStreamableHandle;
+class ASRS_ClimbableSplineActor;
+struct FSRS_BakedRootMotionTrack;
+class USRS_ClimbabilitySet;
+struct FSRS_ClimbabilityClass;
+enum class ESRS_ClimbMove : uint8;
 
 UENUM(BlueprintType)
 namespace ECustomMovementMode
@@ -19,9 +35,102 @@ namespace ECustomMovementMode
 	enum Type
 	{
 		MOVE_Climb UMETA(DisplayName = "Climb Mode"),
+		MOVE_SplineClimb UMETA(DisplayName = "Spline Climb Mode"),
+		MOVE_LedgeHang UMETA(DisplayName = "Ledge Hang Mode"),
+		MOVE_Max UMETA(Hidden),
 	};
 }
 
+class USRS_MovementComponent;
+
+// Point on the edge of a hung ledge, at the top of the wall face
+struct FSRS_LedgePoint
+{
+	FVector Location { FVector::ZeroVector };
+	FVector Normal { FVector::ZeroVector };
+};
+
+// Runtime state of the spline climb mode
+struct FSRS_SplineClimbModeState
+{
+	TWeakObjectPtr<ASRS_ClimbableSplineActor> Spline;
+	float Distance { 0.f };
+};
+
+// Runtime state of the ledge hang mode
+struct FSRS_LedgeHangModeState
+{
+	// Ledge edge extracted on grab and extended while shimmying, ordered along the climber's right at grab time
+	TArray<FSRS_LedgePoint> Points;
+	float Length { 0.f };
+	float Distance { 0.f };
+	// Set once a probe past that end found no ledge, so it is not probed again every tick
+	bool bStartClosed { false };
+	bool bEndClosed { false };
+};
+
+// Physics, limits, transition hooks and runtime state of one custom movement mode, stored in a table indexed by CustomMovementMode
+struct FSRS_CustomMovementModeEntry
+{
+	using FPhysFunction = void (USRS_MovementComponent::*)(float, int32);
+	using FTransitionFunction = void (USRS_MovementComponent::*)();
+
+	FPhysFunction Phys { nullptr };
+	FTransitionFunction OnEnter { nullptr };
+	FTransitionFunction OnExit { nullptr };
+	float MaxSpeed { 0.f };
+	float MaxAcceleration { 0.f };
+
+	// Owned by the mode and reset when it is left, empty for modes that keep none
+	TVariant<FEmptyVariantState, FSRS_SplineClimbModeState, FSRS_LedgeHangModeState> State;
+};
+
+enum class ESRS_ClimbCommandType : uint8
+{
+	StartClimb,
+	StopClimb,
+	Hop
+};
+
+// Climb input buffered until the current traversal montage can take it
+struct FSRS_ClimbCommand
+{
+	ESRS_ClimbCommandType Type { ESRS_ClimbCommandType::StartClimb };
+	FVector InputDirection { FVector::ZeroVector };
+	double ExpireTime { 0.0 };
+};
+
+// Everything needed to carry a climber across a change of representation
+USTRUCT(BlueprintType)
+struct FSRS_ClimbState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Location { FVector::ZeroVector };
+
+	UPROPERTY()
+	FQuat Rotation { FQuat::Identity };
+
+	UPROPERTY()
+	FVector Velocity { FVector::ZeroVector };
+
+	UPROPERTY()
+	FVector SurfaceLocation { FVector::ZeroVector };
+
+	UPROPERTY()
+	FVector SurfaceNormal { FVector::ZeroVector };
+
+	UPROPERTY()
+	TWeakObjectPtr<UPrimitiveComponent> SurfaceComponent;
+
+	UPROPERTY()
+	TEnumAsByte<EMovementMode> MovementMode { MOVE_Walking };
+
+	UPROPERTY()
+	uint8 CustomMovementMode { 0 };
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class CLIMBINGSYSTEM_API USRS_MovementComponent : public UCharacterMovementComponent
 {
@@ -32,22 +141,51 @@ public:
 	FHitResult TraceFromEyeHeight(float TraceDistance, float StartOffset = 0.f);
 
 	void ToggleClimbing(bool bEnableClimbing);
-	void RequestHop();
+	void RequestHop(const FVector& InputDirection);
+
+	void QueueClimbCommand(ESRS_ClimbCommandType Type);
+	void SetClimbInputWindowOpen(bool bOpen);
+	void SetClimbCancelWindowOpen(bool bOpen);
 	bool IsClimbing() const;
+	bool IsSplineClimbing() const;
+	bool IsLedgeHanging() const;
 	bool CanClimb();
 	void StartClimbing();
 	bool CanClimbDown();
 	void StopClimbing();
 	void PhysClimbing(float DeltaTime, int32 Iterations);
+	void PhysSplineClimbing(float DeltaTime, int32 Iterations);
+	void StartSplineClimbing(ASRS_ClimbableSplineActor* Spline);
+	// False, leaving the climber on the spline, when a standing capsule does not fit at the exit
+	bool ExitSplineClimbing(bool bOverTop);
+	void SetClimbableSplineCandidate(ASRS_ClimbableSplineActor* Spline);
+	void ClearClimbableSplineCandidate(ASRS_ClimbableSplineActor* Spline);
+	void PhysLedgeHang(float DeltaTime, int32 Iterations);
+	bool StartLedgeHang();
+	bool MantleLedge();
 	void ProcessClimbableSurface();
+	void ApplyClimbBaseMovement();
+	bool IsClimbAnchorStale() const;
+	void RecordClimbAnchor();
+	void ResolveClimbAnchor();
+	void ClearClimbAnchor();
+	void ApplyClimberSeparation();
 	bool ShouldStopClimbing();
 	bool CheckHasReachedGround();
 	void TryStartVaulting();
 	bool CanVault(FVector& VaultStart, FVector& VaultEnd);
 	FQuat GetClimbRotation(float DeltaTime);
 	void SnapToClimbableSurface(float DeltaTime);
+	FVector GetClimbSnapDelta(float DeltaTime) const;
 	bool HasReachLedge();
-	void PlayClimbMontage(UAnimMontage* MontageToPlay);
+	bool PlayClimbMontage(ESRS_ClimbMontage Montage);
+	bool IsClimbMontageReady(ESRS_ClimbMontage Montage) const;
+	void CompleteClimbTransition(ESRS_ClimbMontage Montage);
+
+	void RequestClimbMontagePreload();
+	void ReleaseClimbMontages();
+	void EnterClimbPreloadRegion();
+	void ExitClimbPreloadRegion();
 
 	FOnEnterClimbState OnEnterClimbState;
 	FOnExitClimbState OnExitClimbState;
@@ -66,23 +204,158 @@ public:
 
 	FORCEINLINE FVector GetClimbableSurfaceLocation() const { return CurrentClimbableSurfaceLocation; }
 	FORCEINLINE FVector GetClimbableSurfaceNormal() const { return CurrentClimbableSurfaceNormal; }
+	FORCEINLINE const TArray<TEnumAsByte<EObjectTypeQuery>>& GetClimbObjectTypes() const { return ClimbObjectTypes; }
+	FORCEINLINE uint8 GetCurrentClimbabilityClassId() const { return CurrentClimbabilityClassId; }
+	const FSRS_ClimbabilityClass& GetClimbabilityClass(uint8 ClassId) const;
+	uint8 GetClimbabilityClassId(UPrimitiveComponent* Component);
+	bool IsClimbMoveAllowed(ESRS_ClimbMove Move) const;
+	bool IsClimbMoveAllowedOn(UPrimitiveComponent* Component, ESRS_ClimbMove Move);
 	FVector GetUnrotatedClimbVelocity() const;
 
+	// Distance matching data for procedural climb locomotion
+	FORCEINLINE float GetClimbDistanceTravelled() const { return ClimbDistanceTravelled; }
+	float PredictClimbStopDistance() const;
+	FORCEINLINE float GetMaxBreakClimbDeceleration() const { return MaxBreakClimbDeceleration; }
+
+	// True on dedicated servers that play baked root motion and never tick the mesh
+	FORCEINLINE bool IsBakedRootMotionOnly() const { return bBakedRootMotionOnly; }
+	// A baked transition plays no montage, check this alongside the anim instance
+	FORCEINLINE bool HasActiveBakedTrack() const { return ActiveBakedTrack != nullptr; }
+
+	void RegisterCustomMovementMode(uint8 Mode, const FSRS_CustomMovementModeEntry& Entry);
+	const FSRS_CustomMovementModeEntry* FindCustomMovementMode(uint8 Mode) const;
+	const FSRS_CustomMovementModeEntry* GetActiveCustomMovementMode() const;
+
+	// Undoes a remote player's climb transition the server rejected, on the server and on the owning client
+	void RejectClimbTransition();
+	FORCEINLINE uint32 GetClimbTransitionSequence() const { return ClimbTransitionSequence; }
+
+	FSRS_ClimbState ExportClimbState() const;
+	void ImportClimbState(const FSRS_ClimbState& State);
+	void ResetClimbState();
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
 	virtual float GetMaxSpeed() const override;
 	virtual float GetMaxAcceleration() const override;
 	virtual FVector ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity, const FVector& CurrentVelocity) const override;
+	virtual void PerformMovement(float DeltaTime) override;
 	
 private:
+	void RegisterCustomMovementModes();
+	void OnEnterClimbing();
+	void OnExitClimbing();
+	void OnEnterSplineClimbing();
+	void OnExitSplineClimbing();
+	void OnEnterLedgeHang();
+	void OnExitLedgeHang();
+
+	bool ProbeLedgePoint(const FVector& Reference, const FVector& WallNormal, FSRS_LedgePoint& OutPoint);
+	bool ExtendLedge(bool bAtEnd);
+	void EvaluateLedge(float Distance, FVector& OutLocation, FVector& OutNormal, FVector& OutTangent) const;
+
+	// Registered custom modes, unused slots have no physics and fall back to the base class limits
+	TArray<FSRS_CustomMovementModeEntry> CustomMovementModes;
+
+	FORCEINLINE FSRS_SplineClimbModeState& GetSplineClimbState() { return CustomMovementModes[ECustomMovementMode::MOVE_SplineClimb].State.Get<FSRS_SplineClimbModeState>(); }
+	FORCEINLINE FSRS_LedgeHangModeState& GetLedgeHangState() { return CustomMovementModes[ECustomMovementMode::MOVE_LedgeHang].State.Get<FSRS_LedgeHangModeState>(); }
+	FORCEINLINE const FSRS_LedgeHangModeState& GetLedgeHangState() const { return CustomMovementModes[ECustomMovementMode::MOVE_LedgeHang].State.Get<FSRS_LedgeHangModeState>(); }
+
 	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowShape = false, bool bDrawPersistent = false);
 	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowShape = false, bool bDrawPersistent = false);
 
+	void ProcessClimbCommands();
+	void ExecuteClimbCommand(const FSRS_ClimbCommand& Command);
+	void PopClimbCommand();
+	void CancelClimbMontage();
+
+	static constexpr int32 ClimbCommandCapacity = 4;
+
+	// Ring buffer of pending commands, the oldest is dropped when a press arrives while it is full
+	TStaticArray<FSRS_ClimbCommand, ClimbCommandCapacity> ClimbCommands;
+	int32 ClimbCommandHead { 0 };
+	int32 NumClimbCommands { 0 };
+
+	// Set by the ClimbInputWindow and ClimbCancelWindow notify states of the playing montage
+	bool bClimbInputWindowOpen { false };
+	bool bClimbCancelWindowOpen { false };
+
+	// How long a press stays buffered outside an input window
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbCommandBufferTime { 0.35f };
+
+	void UpdateClimbMontagePreload(float DeltaTime);
+	bool IsClimbableGeometryNearby() const;
+
+	bool ShouldUseBakedRootMotion() const;
+	bool IsPlayingClimbMontage() const;
+	bool IsClimbMontageActive() const;
+	void AccumulateBakedRootMotion(float DeltaTime);
+	void FinishBakedRootMotion();
+
+	void RecordTelemetrySample();
+	void MarkTelemetryEvent(ESRS_ClimbTelemetryEvent Event);
+
+	TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe> TelemetryStream;
+	uint8 PendingTelemetryEvents { 0 };
+
+	void RecordHeatmapEvent(ESRS_ClimbHeatmapEvent Event);
+
+	// Only set while the heatmap is recording so traces pay a single null check otherwise
+	UPROPERTY()
+	USRS_ClimbHeatmapSubsystem* ClimbHeatmap;
+
+	UPROPERTY()
+	USRS_ClimberSpacingSubsystem* ClimberSpacing;
+
+	// Remote players start climb, climb down, vault and spline climbs locally and ask the server to check and repeat them
+	void SendClimbRequest(ESRS_ClimbClaimType Type, const FVector& VaultStart = FVector::ZeroVector, const FVector& VaultEnd = FVector::ZeroVector);
+	void AbortClimbTransition();
+
+	UFUNCTION(Server, Reliable)
+	void ServerRequestClimbTransition(const FSRS_ClimbRequest& Request);
+
+	UFUNCTION(Server, Reliable)
+	void ServerStopClimbing();
+
+	UFUNCTION(Server, Reliable)
+	void ServerExitSplineClimbing(bool bOverTop);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRejectClimbTransition();
+
+	UPROPERTY()
+	USRS_ClimbValidationSubsystem* ClimbValidation;
+
+	// Montage of an aborted transition, its end must not complete the transition
+	TWeakObjectPtr<UAnimMontage> AbortedClimbMontage;
+
+	// Bumped by every claimed transition and every exit from climbing, a delayed verdict on an older transition must not undo the current one
+	uint32 ClimbTransitionSequence { 0 };
+
+	// Speed at which climbers sharing a wall are pushed apart at contact, fading out at the spacing subsystem's radius. Zero disables spacing.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimberSeparationSpeed { 80.f };
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
 	TArray<TEnumAsByte<EObjectTypeQuery>> ClimbObjectTypes;
+
+	void ApplyClimbabilityClass(uint8 ClassId);
+
+	// Classes the climbed surfaces resolve to, everything climbs the same when unset
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	USRS_ClimbabilitySet* Climbability;
+
+	static constexpr int32 MaxCachedClimbabilityClasses = 256;
+
+	// Class id of every primitive resolved so far, so hits only cost a lookup
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, uint8> ClimbabilityCache;
+	uint8 CurrentClimbabilityClassId { 0 };
+	float CurrentCosMaxFloorAngle { 0.5f };
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
 	float ClimbCapsuleRadius { 50.f };
@@ -105,30 +378,92 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
 	float LedgeTraceDistance { 30.f };
 
+	// How far the climber may drift along the surface normal from the recorded anchor, in the base's local frame, before the surface is swept again.
+	// Zero sweeps every tick.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbAnchorStaleDistance { 10.f };
+
+	// How far the climber may travel along the surface from the recorded anchor before the surface is swept again. Edges and ledges are
+	// noticed up to this late. At the default climb speed and 60 Hz the default sweeps about every twelfth tick while moving, zero every tick.
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbAnchorLateralStaleDistance { 20.f };
+
 	FVector CurrentClimbableSurfaceLocation { FVector::ZeroVector };
 	FVector CurrentClimbableSurfaceNormal { FVector::ZeroVector };
 
-	UPROPERTY()
-	UAnimInstance* OwningPlayerAnimInstance;
+	// Distance moved along the climbed surface since climbing started
+	float ClimbDistanceTravelled { 0.f };
 
-	UPROPERTY()
-	AClimbingSystemCharacter* OwningClimbingCharacter;
+	// Climb anchor stored in the local frame of the climbed primitive so moving and rotating bases carry the climber with them
+	TWeakObjectPtr<UPrimitiveComponent> ClimbBaseComponent;
+	FTransform ClimbBaseTransform { FTransform::Identity };
+	FVector ClimbAnchorLocalLocation { FVector::ZeroVector };
+	FVector ClimbAnchorLocalNormal { FVector::ZeroVector };
+	FVector ClimbAnchorLocalPawnLocation { FVector::ZeroVector };
+	bool bHasClimbAnchor { false };
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* IdleToClimb;
+	// Spline whose trigger the climber is standing in, climbing starts on it instead of sweeping for a surface
+	TWeakObjectPtr<ASRS_ClimbableSplineActor> ClimbableSplineCandidate;
 
+	// Grab climbing ledges and shimmy along them instead of mantling straight away
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* ClimbUpLedge;
+	bool bEnableLedgeHang { true };
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float MaxLedgeShimmySpeed { 80.f };
+
+	// Spacing of the ledge probes, each one costs a downward and a wall trace
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "1.0"))
+	float LedgeProbeSpacing { 25.f };
+
+	// Probes traced either side of the grab point when the ledge is first extracted
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 LedgeInitialProbes { 2 };
 
+	// Points kept in the ledge cache, the ones furthest behind the climber are dropped beyond this
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "2"))
+	int32 MaxLedgePoints { 32 };
+
+	// Hang position relative to the ledge edge: out from the wall and down from the top
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* ClimbDownLedge;
+	float LedgeHangWallOffset { 40.f };
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* Vault;
+	float LedgeHangDropHeight { 90.f };
+
+	UPROPERTY()
+	UAnimInstance* OwningPlayerAnimInstance;
+
+	UPROPERTY()
+	ASRS_ClimberCharacter* OwningClimbingCharacter;
 
+	// Climb montages by soft reference, streamed in while the climber is near climbable geometry or inside a preload region
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* HopUp;
+	USRS_ClimbMontageSet* ClimbMontages;
 
+	// Radius of the throttled probe for climbable geometry that streams the montages in
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbPreloadRadius { 400.f };
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbPreloadProbeInterval { 0.5f };
+
+	// Seconds with nothing climbable nearby before the montages are released
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbMontageReleaseDelay { 10.f };
+
+	TSharedPtr<FStreamableHandle> ClimbMontageHandle;
+	float ClimbPreloadProbeTimer { 0.f };
+	double LastClimbableNearbyTime { 0.0 };
+	int32 ClimbPreloadRegionCount { 0 };
+	bool bBakedRootMotionOnly { false };
+
+	// Root motion baked from the montages in the set, played instead of them on dedicated servers
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
-	UAnimMontage* HopDown;
+	USRS_BakedRootMotionSet* BakedRootMotion;
+
+	ESRS_ClimbMontage ActiveBakedMontage {};
+
+	const FSRS_BakedRootMotionTrack* ActiveBakedTrack { nullptr };
+	float BakedTrackTime { 0.f };
 };
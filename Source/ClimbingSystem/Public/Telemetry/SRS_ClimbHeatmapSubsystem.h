@@ -0,0 +1,77 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimbHeatmapSubsystem.generated.h"
+
+enum class ESRS_ClimbHeatmapEvent : uint8
+{
+	ClimbDropped,
+	EyeTraceRejected,
+	VaultRejected,
+	Num
+};
+
+struct FSRS_ClimbHeatmapCell
+{
+	uint32 EventCounts[static_cast<int32>(ESRS_ClimbHeatmapEvent::Num)] {};
+	uint32 TraceCount { 0 };
+	uint32 TraceHitCount { 0 };
+	uint64 TraceCycles { 0 };
+
+	void Merge(const FSRS_ClimbHeatmapCell& Other);
+	uint32 GetFailureCount() const;
+};
+
+/**
+ * Bins climb failures and climb trace cost into a sparse world grid. Recording goes to per-thread shards
+ * that are merged once per frame. Enabled with srs.ClimbHeatmap.Enable and dumped to Saved/ClimbHeatmap when the world ends,
+ * dumps can be loaded back and drawn over the level with srs.ClimbHeatmap.Load and srs.ClimbHeatmap.Draw.
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API USRS_ClimbHeatmapSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+
+	void RecordEvent(const FVector& Location, ESRS_ClimbHeatmapEvent Event);
+	void RecordTrace(const FVector& Location, int32 NumHits, uint64 Cycles);
+
+	bool DumpToFile(const FString& Path);
+	// Loads into a display grid of its own, a recording world keeps its live cells
+	bool LoadFromFile(const FString& Path);
+	// Draws the loaded grid if there is one, otherwise the live cells
+	void DrawCells(float Duration) const;
+
+private:
+	static constexpr uint32 FileMagic = 0x4D485253; // "SRHM"
+	static constexpr uint32 FileVersion = 1;
+	static constexpr int32 NumShards = 8;
+
+	struct FShard
+	{
+		FCriticalSection Lock;
+		TMap<FIntVector, FSRS_ClimbHeatmapCell> Cells;
+	};
+
+	FShard& GetShardForCurrentThread();
+	FIntVector GetCellKey(const FVector& Location) const;
+	void MergeShards();
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void DrawGrid(const TMap<FIntVector, FSRS_ClimbHeatmapCell>& GridCells, float GridCellSize, float Duration) const;
+
+	FShard Shards[NumShards];
+	TMap<FIntVector, FSRS_ClimbHeatmapCell> Cells;
+	float CellSize { 200.f };
+	TMap<FIntVector, FSRS_ClimbHeatmapCell> LoadedCells;
+	float LoadedCellSize { 200.f };
+	bool bRecording { false };
+	FDelegateHandle PostActorTickHandle;
+};
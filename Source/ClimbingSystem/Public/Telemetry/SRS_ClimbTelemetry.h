@@ -0,0 +1,112 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+enum class ESRS_ClimbTelemetryEvent : uint8
+{
+	None			= 0,
+	ClimbStarted	= 1 << 0,
+	ClimbStopped	= 1 << 1,
+	HopUp			= 1 << 2,
+	HopDown			= 1 << 3,
+	VaultAccepted	= 1 << 4,
+	VaultRejected	= 1 << 5,
+	LedgeReached	= 1 << 6,
+};
+ENUM_CLASS_FLAGS(ESRS_ClimbTelemetryEvent)
+
+// Raw sample as captured on the game thread, quantised later by the writer thread
+struct FSRS_ClimbTelemetrySample
+{
+	uint32 Frame { 0 };
+	uint32 TimeMs { 0 };
+	uint8 MovementMode { 0 };
+	uint8 CustomMovementMode { 0 };
+	uint8 Events { 0 };
+	FVector3f Location { FVector3f::ZeroVector };
+	FVector3f Velocity { FVector3f::ZeroVector };
+	FVector3f SurfaceNormal { FVector3f::ZeroVector };
+};
+
+// Sample as stored on disk: centimetre locations, cm/s velocities and an octahedral normal
+struct FSRS_ClimbTelemetryQuantizedSample
+{
+	uint32 Frame { 0 };
+	uint32 TimeMs { 0 };
+	uint8 MovementMode { 0 };
+	uint8 CustomMovementMode { 0 };
+	uint8 Events { 0 };
+	int32 Normal[2] { 0, 0 };
+	int32 Velocity[3] { 0, 0, 0 };
+	int32 Location[3] { 0, 0, 0 };
+};
+
+struct FSRS_ClimbTelemetryRecord
+{
+	uint32 ClimberId { 0 };
+	FSRS_ClimbTelemetryQuantizedSample Sample;
+};
+
+// Fixed-size single producer (game thread) / single consumer (writer thread) ring owned by one climber
+struct FSRS_ClimbTelemetryStream
+{
+	static constexpr uint32 Capacity = 256;
+
+	explicit FSRS_ClimbTelemetryStream(uint32 InClimberId) : ClimberId(InClimberId) {}
+
+	FORCEINLINE bool Push(const FSRS_ClimbTelemetrySample& Sample)
+	{
+		const uint32 CurrentHead = Head.load(std::memory_order_relaxed);
+		if (CurrentHead - Tail.load(std::memory_order_acquire) >= Capacity)
+		{
+			DroppedSamples.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		Samples[CurrentHead & (Capacity - 1)] = Sample;
+		Head.store(CurrentHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	FORCEINLINE bool Pop(FSRS_ClimbTelemetrySample& OutSample)
+	{
+		const uint32 CurrentTail = Tail.load(std::memory_order_relaxed);
+		if (CurrentTail == Head.load(std::memory_order_acquire)) { return false; }
+		OutSample = Samples[CurrentTail & (Capacity - 1)];
+		Tail.store(CurrentTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	const uint32 ClimberId;
+	std::atomic<uint32> DroppedSamples { 0 };
+	std::atomic<bool> bRetired { false };
+
+	// Only touched by the writer thread
+	FSRS_ClimbTelemetryQuantizedSample LastWritten;
+
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Telemetry ring capacity must be a power of two");
+
+	FSRS_ClimbTelemetrySample Samples[Capacity];
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Head { 0 };
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> Tail { 0 };
+};
+
+/**
+ * Capture file layout: a magic and version header followed by length-prefixed chunks.
+ * Each chunk holds records of a varint climber id followed by zigzag varint deltas against that climber's previous record.
+ */
+struct CLIMBINGSYSTEM_API FSRS_ClimbTelemetryCodec
+{
+	static constexpr uint32 FileMagic = 0x54435253; // "SRCT"
+	static constexpr uint32 FileVersion = 2;
+
+	static FSRS_ClimbTelemetryQuantizedSample Quantize(const FSRS_ClimbTelemetrySample& Sample);
+	static FVector DecodeNormal(const FSRS_ClimbTelemetryQuantizedSample& Sample);
+
+	static void WriteFileHeader(TArray<uint8>& Out);
+	static void EncodeRecord(TArray<uint8>& Out, uint32 ClimberId, const FSRS_ClimbTelemetryQuantizedSample& Current, const FSRS_ClimbTelemetryQuantizedSample& Previous);
+	static bool ReadCapture(const FString& Path, TArray<FSRS_ClimbTelemetryRecord>& OutRecords);
+};
@@ -0,0 +1,22 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SRS_ClimbTelemetryCsvCommandlet.generated.h"
+
+/**
+ * Converts a climb telemetry capture to CSV.
+ * Usage: -run=SRS_ClimbTelemetryCsv -In=<capture.srct> [-Out=<capture.csv>]
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API USRS_ClimbTelemetryCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USRS_ClimbTelemetryCsvCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
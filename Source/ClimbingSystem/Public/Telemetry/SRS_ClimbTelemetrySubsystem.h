@@ -0,0 +1,36 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimbTelemetrySubsystem.generated.h"
+
+struct FSRS_ClimbTelemetryStream;
+class FSRS_ClimbTelemetryWriter;
+
+/**
+ * Per-world climb recorder. Climbers push samples into their own lock-free ring and a background writer
+ * thread quantises, delta-compresses and streams them to Saved/ClimbTelemetry. Enabled with srs.ClimbTelemetry.Enable.
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API USRS_ClimbTelemetrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe> RegisterClimber();
+	void UnregisterClimber(const TSharedPtr<FSRS_ClimbTelemetryStream, ESPMode::ThreadSafe>& Stream);
+
+	FORCEINLINE bool IsRecording() const { return Writer.IsValid(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TSharedPtr<FSRS_ClimbTelemetryWriter> Writer;
+	uint32 NextClimberId { 1 };
+};
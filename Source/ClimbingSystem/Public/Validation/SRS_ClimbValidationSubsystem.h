@@ -0,0 +1,190 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SRS_ClimbValidationSubsystem.generated.h"
+
+class APlayerState;
+class ASRS_ClimbableSplineActor;
+class USRS_MovementComponent;
+
+UENUM()
+enum class ESRS_ClimbClaimType : uint8
+{
+	Climb,
+	ClimbDown,
+	Vault,
+	Spline
+};
+
+// Climb transition a remote client started locally, sent to the server with the geometry the client traced
+USTRUCT()
+struct FSRS_ClimbRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	ESRS_ClimbClaimType Type { ESRS_ClimbClaimType::Climb };
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Forward;
+
+	UPROPERTY()
+	FVector_NetQuantize10 SurfaceLocation;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal SurfaceNormal;
+
+	// Motion warping targets of a vault
+	UPROPERTY()
+	FVector_NetQuantize10 VaultStart;
+
+	UPROPERTY()
+	FVector_NetQuantize10 VaultEnd;
+
+	// Spline a spline climb attaches to
+	UPROPERTY()
+	ASRS_ClimbableSplineActor* Spline { nullptr };
+};
+
+// A remote client's climb request as the server checks it, the claimed geometry has to be consistent with the world and the server's pawn
+struct FSRS_ClimbClaim
+{
+	TWeakObjectPtr<USRS_MovementComponent> Climber;
+	TWeakObjectPtr<APlayerState> Player;
+	ESRS_ClimbClaimType Type { ESRS_ClimbClaimType::Climb };
+	FVector Location { FVector::ZeroVector };
+	FVector Forward { FVector::ForwardVector };
+	FVector Up { FVector::UpVector };
+	FVector SurfaceLocation { FVector::ZeroVector };
+	FVector SurfaceNormal { FVector::ZeroVector };
+	FVector VaultStart { FVector::ZeroVector };
+	FVector VaultEnd { FVector::ZeroVector };
+	TWeakObjectPtr<ASRS_ClimbableSplineActor> Spline;
+	float EyeHeight { 0.f };
+	// Where the server has the climber when the claim arrives
+	FVector ServerLocation { FVector::ZeroVector };
+	double Time { 0.0 };
+	// The climber's transition sequence when the claim arrived, a trace verdict only undoes the transition while it still matches
+	uint32 TransitionSequence { 0 };
+	float Priority { 0.f };
+};
+
+USTRUCT(BlueprintType)
+struct FSRS_ClimbValidationStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 Claims { 0 };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 Escalated { 0 };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 PassedTrace { 0 };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 RejectedByInvariant { 0 };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 RejectedByTrace { 0 };
+
+	// Escalations dropped because the queue was full or the climber was gone before its turn
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 Skipped { 0 };
+
+	// Rejections that came after the climber had moved on to another transition, recorded but not undone
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing")
+	int32 Stale { 0 };
+
+	double LastClaimTime { -1.0 };
+};
+
+/**
+ * Server-side check of remote clients' climb transitions. Every claim is tested against cheap geometric invariants, suspicious ones and a
+ * random sample are escalated to a trace check, and those run highest priority first under a per-frame trace budget.
+ */
+UCLASS(config=Game)
+class CLIMBINGSYSTEM_API USRS_ClimbValidationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// False when the cheap invariants reject the claim outright, escalated claims can still be rejected by a later trace check
+	bool SubmitClaim(const FSRS_ClimbClaim& Claim);
+
+	const FSRS_ClimbValidationStats* FindStats(const APlayerState* Player) const;
+	void DumpStats() const;
+
+	FORCEINLINE int32 GetNumPendingChecks() const { return PendingChecks.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EVerdict : uint8
+	{
+		Accept,
+		Escalate,
+		Reject
+	};
+
+	EVerdict CheckInvariants(const FSRS_ClimbClaim& Claim, const FSRS_ClimbValidationStats& Stats, float& OutPriority) const;
+	bool RunTraceCheck(const FSRS_ClimbClaim& Claim) const;
+	void RejectClaim(const FSRS_ClimbClaim& Claim, const TCHAR* Reason, FSRS_ClimbValidationStats& Stats) const;
+	FSRS_ClimbValidationStats& GetStats(const FSRS_ClimbClaim& Claim);
+
+	// Furthest the client's claimed location may be from where the server has the climber
+	UPROPERTY(Config)
+	float MaxClaimLocationError { 100.f };
+
+	// Furthest the climber may be from the plane of the surface it claims to hold
+	UPROPERTY(Config)
+	float MaxSurfaceDistance { 150.f };
+
+	// Surface distance beyond which a claim is worth a trace check
+	UPROPERTY(Config)
+	float SuspiciousSurfaceDistance { 90.f };
+
+	// Surfaces within this angle of up are floors and cannot be climbed
+	UPROPERTY(Config)
+	float MaxFloorAngle { 60.f };
+
+	UPROPERTY(Config)
+	float MaxVaultReach { 250.f };
+
+	UPROPERTY(Config)
+	float MaxVaultLength { 600.f };
+
+	// Furthest the server's climber may be from where a spline climb would attach it
+	UPROPERTY(Config)
+	float MaxSplineGrabDistance { 200.f };
+
+	// Claims from one player closer together than this are suspicious
+	UPROPERTY(Config)
+	float MinClaimInterval { 0.2f };
+
+	// Share of claims that pass the invariants but are trace checked anyway
+	UPROPERTY(Config)
+	float SpotCheckChance { 0.05f };
+
+	UPROPERTY(Config)
+	int32 MaxPendingChecks { 256 };
+
+	UPROPERTY()
+	TMap<APlayerState*, FSRS_ClimbValidationStats> PlayerStats;
+
+	// Max-heap on FSRS_ClimbClaim::Priority
+	TArray<FSRS_ClimbClaim> PendingChecks;
+};
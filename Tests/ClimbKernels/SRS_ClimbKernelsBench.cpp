@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/SRS_ClimbKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace SRS::ClimbKernels;
+
+namespace
+{
+	// Keeps results alive so the optimiser cannot drop the measured work
+	template <typename T>
+	inline void DoNotOptimize(const T& Value)
+	{
+		asm volatile("" : : "r,m"(Value) : "memory");
+	}
+
+	double MinTimeSeconds = 0.5;
+
+	template <typename FBody>
+	void RunBenchmark(const char* Name, FBody&& Body)
+	{
+		using FClock = std::chrono::steady_clock;
+		long long Iterations = 1;
+		for (;;)
+		{
+			const FClock::time_point Start = FClock::now();
+			for (long long Index = 0; Index < Iterations; ++Index)
+			{
+				Body(Index);
+			}
+			const double Elapsed = std::chrono::duration<double>(FClock::now() - Start).count();
+			if (Elapsed >= MinTimeSeconds || Iterations >= (1LL << 40))
+			{
+				std::printf("%-32s %12.2f ns %15lld iterations\n", Name, Elapsed * 1.e9 / Iterations, Iterations);
+				return;
+			}
+			Iterations *= Elapsed > 0.0 ? (MinTimeSeconds / Elapsed > 10.0 ? 10 : 2) : 10;
+		}
+	}
+
+	std::vector<FVec3> MakeVectors(int Count, unsigned Seed)
+	{
+		std::vector<FVec3> Vectors(Count);
+		std::srand(Seed);
+		for (FVec3& Vector : Vectors)
+		{
+			Vector = { std::rand() / double(RAND_MAX) - 0.5, std::rand() / double(RAND_MAX) - 0.5, std::rand() / double(RAND_MAX) - 0.5 };
+		}
+		return Vectors;
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	for (int Index = 1; Index < Argc; ++Index)
+	{
+		if (std::strncmp(Argv[Index], "--min-time=", 11) == 0)
+		{
+			MinTimeSeconds = std::atof(Argv[Index] + 11);
+		}
+	}
+
+	constexpr int NumVectors = 1024;
+	const std::vector<FVec3> Points = MakeVectors(NumVectors, 1);
+	const std::vector<FVec3> Normals = MakeVectors(NumVectors, 2);
+	const FVec3 Up { 0.0, 0.0, 1.0 };
+	const double CosSixty = DegreesToCos(60.0);
+
+	std::printf("%-32s %15s %26s\n", "Benchmark", "Time", "Iterations");
+
+	RunBenchmark("BM_SurfaceAverage/8", [&](long long Iteration)
+	{
+		FSurfaceAccumulator Surface;
+		const int Offset = int(Iteration % (NumVectors - 8));
+		for (int Hit = 0; Hit < 8; ++Hit)
+		{
+			Surface.Add(Points[Offset + Hit], Normals[Offset + Hit]);
+		}
+		DoNotOptimize(Surface.GetLocation());
+		DoNotOptimize(Surface.GetNormal());
+	});
+
+	RunBenchmark("BM_IsSurfaceTooFlat", [&](long long Iteration)
+	{
+		DoNotOptimize(IsSurfaceTooFlat(Normals[Iteration % NumVectors], Up, CosSixty));
+	});
+
+	RunBenchmark("BM_ComputeSnapVector", [&](long long Iteration)
+	{
+		const int Index = int(Iteration % (NumVectors - 1));
+		DoNotOptimize(ComputeSnapVector(Points[Index], Points[Index + 1], Normals[Index], Normals[Index + 1]));
+	});
+
+	RunBenchmark("BM_ClassifyHop", [&](long long Iteration)
+	{
+		DoNotOptimize(ClassifyHop(Points[Iteration % NumVectors], Normals[Iteration % NumVectors]));
+	});
+
+	RunBenchmark("BM_SelectVaultPoints", [&](long long Iteration)
+	{
+		FVaultProbeResult Probes[VaultProbeCount];
+		for (int Probe = 0; Probe < VaultProbeCount; ++Probe)
+		{
+			FVec3 Start, End;
+			GetVaultProbe(Probe, Points[Iteration % NumVectors], Normals[0], Up, Start, End);
+			Probes[Probe] = { ((Iteration >> Probe) & 1) != 0, End };
+		}
+		FVec3 VaultStart, VaultEnd;
+		DoNotOptimize(SelectVaultPoints(Probes, VaultProbeCount, VaultStart, VaultEnd));
+	});
+
+	return 0;
+}
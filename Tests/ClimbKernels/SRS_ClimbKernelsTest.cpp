@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Math/SRS_ClimbKernels.h"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace SRS::ClimbKernels;
+
+namespace
+{
+	int Failures = 0;
+
+	void Check(bool bCondition, const char* Expression, int Line)
+	{
+		if (!bCondition)
+		{
+			std::printf("FAILED line %d: %s\n", Line, Expression);
+			++Failures;
+		}
+	}
+
+	bool NearlyEqual(const FVec3& A, const FVec3& B, double Tolerance = 1.e-9)
+	{
+		return std::fabs(A.X - B.X) <= Tolerance && std::fabs(A.Y - B.Y) <= Tolerance && std::fabs(A.Z - B.Z) <= Tolerance;
+	}
+}
+
+#define CHECK(Expression) Check((Expression), #Expression, __LINE__)
+
+static void TestSurfaceAverage()
+{
+	FSurfaceAccumulator Empty;
+	CHECK(IsZero(Empty.GetLocation()));
+	CHECK(IsZero(Empty.GetNormal()));
+
+	FSurfaceAccumulator Surface;
+	Surface.Add({ 0.0, 0.0, 0.0 }, { -1.0, 0.0, 0.0 });
+	Surface.Add({ 0.0, 10.0, 20.0 }, { 0.0, -1.0, 0.0 });
+	CHECK(NearlyEqual(Surface.GetLocation(), { 0.0, 5.0, 10.0 }));
+	const double InvSqrt2 = 1.0 / std::sqrt(2.0);
+	CHECK(NearlyEqual(Surface.GetNormal(), { -InvSqrt2, -InvSqrt2, 0.0 }));
+
+	// Opposing normals cancel out to a zero normal rather than NaNs
+	FSurfaceAccumulator Opposed;
+	Opposed.Add({}, { 1.0, 0.0, 0.0 });
+	Opposed.Add({}, { -1.0, 0.0, 0.0 });
+	CHECK(IsZero(Opposed.GetNormal()));
+}
+
+static void TestSlope()
+{
+	const FVec3 Up { 0.0, 0.0, 1.0 };
+	const double CosSixty = DegreesToCos(60.0);
+	CHECK(IsSurfaceTooFlat(Up, Up, CosSixty));
+	CHECK(!IsSurfaceTooFlat({ -1.0, 0.0, 0.0 }, Up, CosSixty));
+	CHECK(!IsSurfaceTooFlat({}, Up, CosSixty));
+
+	// 50 degrees from up is a floor, 70 degrees is a wall
+	const double Fifty = 50.0 * 3.14159265358979323846 / 180.0;
+	const double Seventy = 70.0 * 3.14159265358979323846 / 180.0;
+	CHECK(IsSurfaceTooFlat({ std::sin(Fifty), 0.0, std::cos(Fifty) }, Up, CosSixty));
+	CHECK(!IsSurfaceTooFlat({ std::sin(Seventy), 0.0, std::cos(Seventy) }, Up, CosSixty));
+
+	// Slightly denormalised up normals still count as floors
+	CHECK(IsSurfaceTooFlat({ 0.0, 0.0, 1.0000001 }, Up, CosSixty));
+}
+
+static void TestSnap()
+{
+	const FVec3 Snap = ComputeSnapVector({ 100.0, 0.0, 0.0 }, { 40.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0 }, { -1.0, 0.0, 0.0 });
+	CHECK(NearlyEqual(Snap, { 60.0, 0.0, 0.0 }));
+
+	// Only the forward component of the offset counts
+	const FVec3 Sideways = ComputeSnapVector({ 10.0, 500.0, 0.0 }, {}, { 1.0, 0.0, 0.0 }, { -1.0, 0.0, 0.0 });
+	CHECK(NearlyEqual(Sideways, { 10.0, 0.0, 0.0 }));
+
+	CHECK(IsZero(ComputeSnapVector({ 10.0, 0.0, 0.0 }, {}, {}, { -1.0, 0.0, 0.0 })));
+}
+
+static void TestHop()
+{
+	const FVec3 Right { 0.0, 1.0, 0.0 };
+	CHECK(ClassifyHop({ 0.0, 0.0, 1.0 }, Right) == EHopDirection::Up);
+	CHECK(ClassifyHop({ 0.0, 0.0, -3.0 }, Right) == EHopDirection::Down);
+	CHECK(ClassifyHop({ 0.0, 2.0, 0.1 }, Right) == EHopDirection::Right);
+	CHECK(ClassifyHop({ 0.0, -1.0, 0.0 }, Right) == EHopDirection::Left);
+	CHECK(ClassifyHop({ 0.0, 1.0, 1.0 }, Right) == EHopDirection::None);
+	CHECK(ClassifyHop({}, Right) == EHopDirection::None);
+}
+
+static void TestVault()
+{
+	FVec3 Start, End;
+	GetVaultProbe(0, { 0.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, Start, End);
+	CHECK(NearlyEqual(Start, { 100.0, 0.0, 100.0 }));
+	CHECK(NearlyEqual(End, { 100.0, 0.0, 0.0 }));
+	GetVaultProbe(4, { 0.0, 0.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0 }, Start, End);
+	CHECK(NearlyEqual(Start, { 500.0, 0.0, 100.0 }));
+	CHECK(NearlyEqual(End, { 500.0, 0.0, -400.0 }));
+
+	FVaultProbeResult Probes[VaultProbeCount];
+	CHECK(!SelectVaultPoints(Probes, VaultProbeCount, Start, End));
+
+	Probes[0] = { true, { 100.0, 0.0, 50.0 } };
+	CHECK(!SelectVaultPoints(Probes, VaultProbeCount, Start, End));
+	CHECK(NearlyEqual(Start, { 100.0, 0.0, 50.0 }));
+
+	Probes[VaultProbeCount - 1] = { true, { 500.0, 0.0, -10.0 } };
+	CHECK(SelectVaultPoints(Probes, VaultProbeCount, Start, End));
+	CHECK(NearlyEqual(End, { 500.0, 0.0, -10.0 }));
+
+	// Middle probes never change the selection, which is why CanVault skips tracing them
+	FVaultProbeResult MiddleHits[VaultProbeCount];
+	MiddleHits[0] = Probes[0];
+	MiddleHits[VaultProbeCount - 1] = Probes[VaultProbeCount - 1];
+	for (int Probe = 1; Probe < VaultProbeCount - 1; ++Probe)
+	{
+		MiddleHits[Probe] = { true, { 100.0 * (Probe + 1), 0.0, 75.0 } };
+	}
+	FVec3 MiddleStart, MiddleEnd;
+	CHECK(SelectVaultPoints(MiddleHits, VaultProbeCount, MiddleStart, MiddleEnd));
+	CHECK(NearlyEqual(MiddleStart, Start) && NearlyEqual(MiddleEnd, End));
+
+	CHECK(!SelectVaultPoints(Probes, 0, Start, End));
+}
+
+int main()
+{
+	TestSurfaceAverage();
+	TestSlope();
+	TestSnap();
+	TestHop();
+	TestVault();
+
+	if (Failures > 0)
+	{
+		std::printf("%d check(s) failed\n", Failures);
+		return 1;
+	}
+	std::printf("All climb kernel checks passed\n");
+	return 0;
+}